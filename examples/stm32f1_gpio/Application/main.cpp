@@ -36,17 +36,12 @@ void setup() {
     dummyCpp = 0;
     dummyCandCpp = 0;
 
-    pinPb0.setup();
-    pinPb0.setOnChangeCallback([]() {
-        pinPb0.isOn() ? led2.setOn() : led2.setOff();
-    });
-    pinPb1.setup();
-    pinPa0.setup();
-
-    led1.setup();
-    led2.setup();
-    led3.setup();
-    led4.setup();
+    Stm32Gpio::PinManager::setupAll();
+
+    pinPb0.setOnChangeCallback([](void *context, Stm32Gpio::PinInterface *, const Stm32Gpio::PinEvent &event) {
+        auto *led = static_cast<Stm32Gpio::PinDigitalOut *>(context);
+        event.on ? led->setOn() : led->setOff();
+    }, &led2);
 
     led1.setOff();
     led2.setOff();
@@ -69,13 +64,7 @@ void loop() {
     dummyCpp++;
     dummyCandCpp++;
 
-    pinPb0.loop();
-    pinPb1.loop();
-    pinPa0.loop();
-    led1.loop();
-    led2.loop();
-    led3.loop();
-    led4.loop();
+    Stm32Gpio::PinManager::loopAll();
 
     // pinPb0.isOn() ? led2.setOn() : led2.setOff();
     // HAL_GPIO_WritePin(LED2_ORG_GPIO_Port, LED2_ORG_Pin, pinPb0.isOn() ? GPIO_PIN_SET : GPIO_PIN_RESET);
@@ -0,0 +1,124 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "AdcAsyncConverter.hpp"
+
+#ifdef HAL_ADC_MODULE_ENABLED
+
+#include "Helper.hpp"
+
+using namespace Stm32Gpio;
+
+AdcAsyncConverter *AdcAsyncConverter::first = nullptr;
+
+AdcAsyncConverter::AdcAsyncConverter(ADC_HandleTypeDef *hadc, const bool useInterrupt)
+    : hadc(hadc), useInterrupt(useInterrupt), next(first) {
+    first = this;
+}
+
+AdcAsyncConverter::~AdcAsyncConverter() {
+    for (AdcAsyncConverter **link = &first; *link != nullptr; link = &(*link)->next) {
+        if (*link == this) {
+            *link = next;
+            return;
+        }
+    }
+}
+
+uint8_t AdcAsyncConverter::addChannel(const uint32_t ADC_Channel) {
+    for (uint8_t i = 0; i < channelCount; i++) {
+        if (channels[i] == ADC_Channel) return i;
+    }
+    if (channelCount >= maxChannels) return maxChannels;
+    channels[channelCount] = ADC_Channel;
+    return channelCount++;
+}
+
+void AdcAsyncConverter::poll() {
+    if (channelCount == 0) return;
+
+    if (state == stateType::CONVERTING) {
+        if (!useInterrupt && __HAL_ADC_GET_FLAG(hadc, ADC_FLAG_EOC)) {
+            resultValue = static_cast<uint16_t>(HAL_ADC_GetValue(hadc));
+            resultMs = millis();
+            state = stateType::DONE;
+        } else if ((millis() - conversionStartMs) >= LIBSMART_STM32GPIO_ADC_ASYNC_TIMEOUT_MS) {
+            // No result, skip the channel
+            useInterrupt ? HAL_ADC_Stop_IT(hadc) : HAL_ADC_Stop(hadc);
+            state = stateType::IDLE;
+            current = (current + 1) % channelCount;
+        } else {
+            return;
+        }
+    }
+
+    if (state == stateType::DONE) {
+        useInterrupt ? HAL_ADC_Stop_IT(hadc) : HAL_ADC_Stop(hadc);
+        storeResult();
+        current = (current + 1) % channelCount;
+    }
+
+    startConversion();
+}
+
+uint32_t AdcAsyncConverter::millisSinceSample(const uint8_t index) const {
+    return millis() - sampleMs[index];
+}
+
+void AdcAsyncConverter::handleConversionComplete() {
+    if (state != stateType::CONVERTING) return;
+    resultValue = static_cast<uint16_t>(HAL_ADC_GetValue(hadc));
+    resultMs = millis();
+    state = stateType::DONE;
+}
+
+void AdcAsyncConverter::dispatchConversionComplete(const ADC_HandleTypeDef *hadc) {
+    for (AdcAsyncConverter *converter = first; converter != nullptr; converter = converter->next) {
+        if (converter->hadc == hadc) {
+            converter->handleConversionComplete();
+            return;
+        }
+    }
+}
+
+void AdcAsyncConverter::startConversion() {
+    ADC_ChannelConfTypeDef sConfig = {};
+    sConfig.Channel = channels[current];
+    sConfig.Rank = 1;
+#ifdef STM32F1
+    sConfig.SamplingTime = ADC_SAMPLETIME_71CYCLES_5;
+#endif
+#ifdef STM32F4
+    sConfig.SamplingTime = ADC_SAMPLETIME_84CYCLES;
+    sConfig.Offset = 0;
+#endif
+    HAL_ADC_ConfigChannel(hadc, &sConfig);
+
+    conversionStartMs = millis();
+    state = stateType::CONVERTING;
+    if ((useInterrupt ? HAL_ADC_Start_IT(hadc) : HAL_ADC_Start(hadc)) != HAL_OK) {
+        state = stateType::IDLE;
+    }
+}
+
+void AdcAsyncConverter::storeResult() {
+    samples[current] = resultValue;
+    sampleMs[current] = resultMs;
+    sampleSequence[current]++;
+    sampledMask |= 1u << current;
+    state = stateType::IDLE;
+}
+
+void Stm32Gpio_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc) {
+    AdcAsyncConverter::dispatchConversionComplete(hadc);
+}
+
+#ifdef LIBSMART_STM32GPIO_DEFINE_ADC_CALLBACKS
+extern "C" void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc) {
+    AdcAsyncConverter::dispatchConversionComplete(hadc);
+}
+#endif
+
+#endif
@@ -0,0 +1,169 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32GPIO_ADCASYNCCONVERTER_HPP
+#define LIBSMART_STM32GPIO_ADCASYNCCONVERTER_HPP
+
+#include "libsmart_config.hpp"
+#include <main.h>
+#include <cstdint>
+
+#ifdef HAL_ADC_MODULE_ENABLED
+
+/**
+ * Maximum number of channels of an AdcAsyncConverter.
+ */
+#ifndef LIBSMART_STM32GPIO_ADC_ASYNC_MAX_CHANNELS
+#define LIBSMART_STM32GPIO_ADC_ASYNC_MAX_CHANNELS 8
+#endif
+
+/**
+ * Time in milliseconds, after which a conversion without result is aborted and the next channel is started.
+ */
+#ifndef LIBSMART_STM32GPIO_ADC_ASYNC_TIMEOUT_MS
+#define LIBSMART_STM32GPIO_ADC_ASYNC_TIMEOUT_MS 10
+#endif
+
+namespace Stm32Gpio {
+    /**
+     * @class AdcAsyncConverter
+     * @brief Converts the channels of an ADC one after the other, without waiting for a conversion.
+     *
+     * poll() runs a small state machine: it starts the conversion of the next channel and returns immediately.
+     * A later call picks up the result, stores it together with its timestamp and starts the next channel
+     * (round robin). In interrupt mode, the result is picked up by Stm32Gpio_ADC_ConvCpltCallback() as soon as
+     * the conversion is complete, and poll() only starts the next channel.
+     *
+     * The PinAnalogIn pins of the converter register their channels at construction and call poll() from
+     * loop(). The ADC has to be initialized for single conversions of one channel, as generated by CubeMX.
+     */
+    class AdcAsyncConverter {
+    public:
+        static constexpr uint8_t maxChannels = LIBSMART_STM32GPIO_ADC_ASYNC_MAX_CHANNELS;
+
+        AdcAsyncConverter() = delete;
+
+        /**
+         * @param hadc Pointer to the ADC handle. The converter owns the ADC.
+         * @param useInterrupt true to pick up the results by the conversion complete interrupt. The ADC
+         * interrupt has to be enabled and HAL_ADC_ConvCpltCallback() has to call Stm32Gpio_ADC_ConvCpltCallback().
+         */
+        explicit AdcAsyncConverter(ADC_HandleTypeDef *hadc, bool useInterrupt = false);
+
+        ~AdcAsyncConverter();
+
+        /**
+         * @brief Add a channel to the round robin.
+         *
+         * @param ADC_Channel The ADC channel, e.g. ADC_CHANNEL_8.
+         * @return The index of the channel, or maxChannels if the converter is full.
+         */
+        uint8_t addChannel(uint32_t ADC_Channel);
+
+        /**
+         * @brief Advance the state machine. Never waits for the ADC.
+         */
+        void poll();
+
+        /**
+         * @brief Get the last completed sample of a channel.
+         *
+         * @param index The index, as returned by addChannel().
+         * @return The ADC value, 0 if the channel has not been converted yet.
+         */
+        uint16_t read(const uint8_t index) const { return samples[index]; }
+
+        /**
+         * @brief Get the number of milliseconds since the last sample of a channel was taken.
+         *
+         * @param index The index, as returned by addChannel().
+         * @return The age of the sample in milliseconds.
+         */
+        uint32_t millisSinceSample(uint8_t index) const;
+
+        /**
+         * @brief Check if a channel has been converted at least once.
+         *
+         * @param index The index, as returned by addChannel().
+         * @return true if read() returns a converted value, false otherwise.
+         */
+        bool hasSample(const uint8_t index) const { return (sampledMask & (1u << index)) != 0; }
+
+        /**
+         * @brief Get the sequence number of the last completed sample of a channel.
+         *
+         * The number is incremented with every result, that is stored for the channel. A caller, that keeps the
+         * number of the sample it processed, detects a new conversion by comparing it.
+         *
+         * @param index The index, as returned by addChannel().
+         * @return The number of samples, that have been stored for the channel (wrapping).
+         */
+        uint32_t getSampleSequence(const uint8_t index) const { return sampleSequence[index]; }
+
+        /**
+         * @brief Get the ADC handle of the converter.
+         */
+        ADC_HandleTypeDef *getAdc() const { return hadc; }
+
+        /**
+         * @brief Take the result of the running conversion.
+         *
+         * This method is called by Stm32Gpio_ADC_ConvCpltCallback() in interrupt context and should not be
+         * called directly.
+         */
+        void handleConversionComplete();
+
+        /**
+         * @brief Find the converter of an ADC handle and let it take the result.
+         *
+         * @param hadc Pointer to the ADC handle, as passed to HAL_ADC_ConvCpltCallback().
+         */
+        static void dispatchConversionComplete(const ADC_HandleTypeDef *hadc);
+
+    private:
+        using stateType = enum class stateType {
+            IDLE, CONVERTING, DONE
+        };
+
+        void startConversion();
+
+        void storeResult();
+
+        ADC_HandleTypeDef *hadc;
+        bool useInterrupt;
+
+        uint32_t channels[maxChannels] = {};
+        uint16_t samples[maxChannels] = {};
+        uint32_t sampleMs[maxChannels] = {};
+        uint32_t sampleSequence[maxChannels] = {};
+        uint32_t sampledMask = 0;
+        uint8_t channelCount = 0;
+
+        /**
+         * @brief Index of the channel, that is converted.
+         */
+        uint8_t current = 0;
+        uint32_t conversionStartMs = 0;
+
+        /**
+         * @brief State of the conversion, written by poll() and by the interrupt.
+         */
+        volatile stateType state = stateType::IDLE;
+
+        /**
+         * @brief Result of the conversion, written by the interrupt before the state is set to DONE.
+         */
+        volatile uint16_t resultValue = 0;
+        volatile uint32_t resultMs = 0;
+
+        AdcAsyncConverter *next = nullptr;
+        static AdcAsyncConverter *first;
+    };
+}
+
+extern "C" void Stm32Gpio_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc);
+
+#endif
+#endif //LIBSMART_STM32GPIO_ADCASYNCCONVERTER_HPP
@@ -0,0 +1,132 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "AdcScanGroup.hpp"
+
+#if defined(HAL_ADC_MODULE_ENABLED) && defined(HAL_DMA_MODULE_ENABLED)
+
+#include "PinAnalogIn.hpp"
+
+using namespace Stm32Gpio;
+
+AdcScanGroup *AdcScanGroup::first = nullptr;
+
+AdcScanGroup::~AdcScanGroup() {
+    for (AdcScanGroup **link = &first; *link != nullptr; link = &(*link)->next) {
+        if (*link == this) {
+            *link = next;
+            return;
+        }
+    }
+}
+
+uint8_t AdcScanGroup::addChannel(const uint32_t ADC_Channel) {
+    for (uint8_t i = 0; i < channelCount; i++) {
+        if (channels[i] == ADC_Channel) return i;
+    }
+    if (channelCount >= maxChannels) return maxChannels;
+    channels[channelCount] = ADC_Channel;
+    return channelCount++;
+}
+
+bool AdcScanGroup::start() {
+    if (running && (runningChannelCount == channelCount)) return true;
+    if (channelCount == 0) return false;
+    stop();
+
+    hadc->Init.ScanConvMode = ADC_SCAN_ENABLE;
+    hadc->Init.ContinuousConvMode = ENABLE;
+    hadc->Init.DiscontinuousConvMode = DISABLE;
+    hadc->Init.NbrOfConversion = channelCount;
+#ifdef STM32F4
+    hadc->Init.DMAContinuousRequests = ENABLE;
+    hadc->Init.EOCSelection = ADC_EOC_SEQ_CONV;
+#endif
+    if (HAL_ADC_Init(hadc) != HAL_OK) return false;
+
+    for (uint8_t i = 0; i < channelCount; i++) {
+        ADC_ChannelConfTypeDef sConfig = {};
+        sConfig.Channel = channels[i];
+        sConfig.Rank = i + 1;
+#ifdef STM32F1
+        sConfig.SamplingTime = ADC_SAMPLETIME_71CYCLES_5;
+#endif
+#ifdef STM32F4
+        sConfig.SamplingTime = ADC_SAMPLETIME_84CYCLES;
+        sConfig.Offset = 0;
+#endif
+        if (HAL_ADC_ConfigChannel(hadc, &sConfig) != HAL_OK) return false;
+    }
+
+#ifdef STM32F1
+    HAL_ADCEx_Calibration_Start(hadc);
+#endif
+
+    // The DMA transfers half words, HAL only takes the address of the array
+    auto *data = reinterpret_cast<uint32_t *>(const_cast<uint16_t *>(samples));
+    if (HAL_ADC_Start_DMA(hadc, data, channelCount) != HAL_OK) return false;
+
+    runningChannelCount = channelCount;
+    running = true;
+    return true;
+}
+
+void AdcScanGroup::stop() {
+    if (!running) return;
+    HAL_ADC_Stop_DMA(hadc);
+    running = false;
+}
+
+bool AdcScanGroup::armWatchdog(PinAnalogIn *pin, const uint8_t index, const uint32_t low, const uint32_t high) {
+    if ((watchdogPin != nullptr) && (watchdogPin != pin)) return false;
+    if (index >= channelCount) return false;
+
+    ADC_AnalogWDGConfTypeDef awdConfig = {};
+    awdConfig.WatchdogMode = ADC_ANALOGWATCHDOG_SINGLE_REG;
+    awdConfig.Channel = channels[index];
+    awdConfig.ITMode = ENABLE;
+    awdConfig.HighThreshold = high;
+    awdConfig.LowThreshold = low;
+
+    watchdogPin = pin;
+    __HAL_ADC_CLEAR_FLAG(hadc, ADC_FLAG_AWD);
+    if (HAL_ADC_AnalogWDGConfig(hadc, &awdConfig) != HAL_OK) {
+        watchdogPin = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void AdcScanGroup::releaseWatchdog(const PinAnalogIn *pin) {
+    if (watchdogPin != pin) return;
+    __HAL_ADC_DISABLE_IT(hadc, ADC_IT_AWD);
+    ADC_AnalogWDGConfTypeDef awdConfig = {};
+    awdConfig.WatchdogMode = ADC_ANALOGWATCHDOG_NONE;
+    awdConfig.ITMode = DISABLE;
+    HAL_ADC_AnalogWDGConfig(hadc, &awdConfig);
+    watchdogPin = nullptr;
+}
+
+void AdcScanGroup::dispatchWatchdog(ADC_HandleTypeDef *hadc) {
+    for (AdcScanGroup *group = first; group != nullptr; group = group->next) {
+        if (group->hadc != hadc) continue;
+        // The interrupt would fire on every conversion, until the pin has evaluated the new value
+        __HAL_ADC_DISABLE_IT(hadc, ADC_IT_AWD);
+        group->watchdogPin != nullptr ? group->watchdogPin->handleWatchdog() : (void) nullptr;
+        return;
+    }
+}
+
+void Stm32Gpio_ADC_LevelOutOfWindowCallback(ADC_HandleTypeDef *hadc) {
+    AdcScanGroup::dispatchWatchdog(hadc);
+}
+
+#ifdef LIBSMART_STM32GPIO_DEFINE_ADC_CALLBACKS
+extern "C" void HAL_ADC_LevelOutOfWindowCallback(ADC_HandleTypeDef *hadc) {
+    AdcScanGroup::dispatchWatchdog(hadc);
+}
+#endif
+
+#endif
@@ -0,0 +1,149 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32GPIO_ADCSCANGROUP_HPP
+#define LIBSMART_STM32GPIO_ADCSCANGROUP_HPP
+
+#include "libsmart_config.hpp"
+#include <main.h>
+#include <cstdint>
+
+#if defined(HAL_ADC_MODULE_ENABLED) && defined(HAL_DMA_MODULE_ENABLED)
+
+/**
+ * Maximum number of channels in the regular sequence of an AdcScanGroup.
+ */
+#ifndef LIBSMART_STM32GPIO_ADC_SCAN_MAX_CHANNELS
+#define LIBSMART_STM32GPIO_ADC_SCAN_MAX_CHANNELS 16
+#endif
+
+namespace Stm32Gpio {
+    class PinAnalogIn;
+
+    /**
+     * @class AdcScanGroup
+     * @brief Converts all channels of an ADC in one continuous scan, with circular DMA into a sample array.
+     *
+     * The PinAnalogIn pins of the group register their channels at construction. On the first setup() of such
+     * a pin, the group configures one regular sequence with all channels and starts the ADC in continuous scan
+     * mode. From then on, the DMA keeps the sample array up to date and reading a value is a plain memory load.
+     * Pins on the same channel share one rank of the sequence.
+     *
+     * A DMA channel (peripheral to memory, half word width, circular mode) has to be linked to the ADC,
+     * as generated by CubeMX. The group owns the ADC, so it must not be used by anything else.
+     *
+     * The analog watchdog of the ADC can guard one channel of the group, see PinAnalogIn::enableWatchdog().
+     * This needs the ADC interrupt and HAL_ADC_LevelOutOfWindowCallback() has to call
+     * Stm32Gpio_ADC_LevelOutOfWindowCallback().
+     */
+    class AdcScanGroup {
+    public:
+        static constexpr uint8_t maxChannels = LIBSMART_STM32GPIO_ADC_SCAN_MAX_CHANNELS;
+
+        AdcScanGroup() = delete;
+
+        explicit AdcScanGroup(ADC_HandleTypeDef *hadc) : hadc(hadc), next(first) {
+            first = this;
+        }
+
+        ~AdcScanGroup();
+
+        /**
+         * @brief Add a channel to the regular sequence.
+         *
+         * If the group is already running, the sequence is reconfigured on the next call of start().
+         *
+         * @param ADC_Channel The ADC channel, e.g. ADC_CHANNEL_8.
+         * @return The index of the channel in the sample array, or maxChannels if the sequence is full.
+         */
+        uint8_t addChannel(uint32_t ADC_Channel);
+
+        /**
+         * @brief Configure the regular sequence and start the continuous conversion.
+         *
+         * Does nothing, if the group is already running with all channels.
+         *
+         * @return true on success, false otherwise.
+         */
+        bool start();
+
+        /**
+         * @brief Stop the conversion.
+         */
+        void stop();
+
+        /**
+         * @brief Check if the group is converting.
+         *
+         * @return true if the DMA keeps the samples up to date, false otherwise.
+         */
+        bool isRunning() const { return running; }
+
+        /**
+         * @brief Get the latest sample of a channel.
+         *
+         * @param index The index, as returned by addChannel().
+         * @return The ADC value.
+         */
+        uint16_t read(const uint8_t index) const { return samples[index]; }
+
+        /**
+         * @brief Get the ADC handle of the group.
+         */
+        ADC_HandleTypeDef *getAdc() const { return hadc; }
+
+        /**
+         * @brief Let the analog watchdog of the ADC guard a channel of the group.
+         *
+         * The watchdog interrupt is raised, as soon as a sample of the channel is outside of [low, high].
+         * It is disabled by the interrupt and has to be armed again. The ADC has one watchdog, so only one pin
+         * can use it at a time.
+         *
+         * @param pin The pin, that is notified by PinAnalogIn::handleWatchdog().
+         * @param index The index of the channel, as returned by addChannel().
+         * @param low The low threshold.
+         * @param high The high threshold.
+         * @return true on success, false if the watchdog is used by another pin or cannot be configured.
+         */
+        bool armWatchdog(PinAnalogIn *pin, uint8_t index, uint32_t low, uint32_t high);
+
+        /**
+         * @brief Stop the analog watchdog and release it.
+         *
+         * @param pin The pin, that armed the watchdog.
+         */
+        void releaseWatchdog(const PinAnalogIn *pin);
+
+        /**
+         * @brief Find the scan group of an ADC handle and notify its watchdog pin.
+         *
+         * @param hadc Pointer to the ADC handle, as passed to HAL_ADC_LevelOutOfWindowCallback().
+         */
+        static void dispatchWatchdog(ADC_HandleTypeDef *hadc);
+
+    private:
+        ADC_HandleTypeDef *hadc;
+        uint32_t channels[maxChannels] = {};
+
+        /**
+         * @brief The sample array, written by the DMA.
+         */
+        volatile uint16_t samples[maxChannels] = {};
+
+        uint8_t channelCount = 0;
+        uint8_t runningChannelCount = 0;
+        bool running = false;
+
+        PinAnalogIn *watchdogPin = nullptr;
+
+        AdcScanGroup *next = nullptr;
+        static AdcScanGroup *first;
+    };
+}
+
+extern "C" void Stm32Gpio_ADC_LevelOutOfWindowCallback(ADC_HandleTypeDef *hadc);
+
+#endif
+#endif //LIBSMART_STM32GPIO_ADCSCANGROUP_HPP
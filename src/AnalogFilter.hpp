@@ -0,0 +1,185 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32GPIO_ANALOGFILTER_HPP
+#define LIBSMART_STM32GPIO_ANALOGFILTER_HPP
+
+#include <cstdint>
+#include <initializer_list>
+#include <tuple>
+#include <type_traits>
+
+namespace Stm32Gpio {
+    /**
+     * @brief Marks a filter, whose output scale is not known, see FilterExtraBits.
+     */
+    constexpr uint8_t unknownFilterScale = 0xFF;
+
+    /**
+     * @brief Get the number of bits, that a filter adds to its input, e.g. by oversampling.
+     *
+     * Filters declare this by a member static constexpr uint8_t extraBits. For other filters, value is
+     * unknownFilterScale.
+     */
+    template<typename Filter, typename = void>
+    struct FilterExtraBits {
+        static constexpr uint8_t value = unknownFilterScale;
+    };
+
+    template<typename Filter>
+    struct FilterExtraBits<Filter, std::void_t<decltype(Filter::extraBits)>> {
+        static constexpr uint8_t value = Filter::extraBits;
+    };
+
+    /**
+     * @class ExponentialFilter
+     * @brief First order IIR low pass: y += (x - y) / 2^Shift.
+     *
+     * The state is kept with Shift fractional bits, so small steps are not lost. The first sample initializes
+     * the filter, so there is no ramp up from 0. The state has 64 bits, so any 32 bit input, e.g. the 18 bit
+     * output of an OversampleFilter<6>, fits with all fractional bits.
+     *
+     * @tparam Shift Smoothing factor. The time constant is about 2^Shift samples.
+     */
+    template<uint8_t Shift>
+    class ExponentialFilter {
+        static_assert((Shift > 0) && (Shift < 16), "Shift has to be in the range 1..15");
+
+    public:
+        static constexpr uint8_t extraBits = 0;
+
+        uint32_t filter(const uint32_t sample) {
+            if (!initialized) {
+                accumulator = static_cast<uint64_t>(sample) << Shift;
+                initialized = true;
+            } else {
+                accumulator = accumulator - (accumulator >> Shift) + sample;
+            }
+            return static_cast<uint32_t>(accumulator >> Shift);
+        }
+
+    private:
+        uint64_t accumulator = 0;
+        bool initialized = false;
+    };
+
+
+    /**
+     * @class MovingAverageFilter
+     * @brief Boxcar average over the last Length samples.
+     *
+     * A running sum is kept, so each sample costs one addition and one subtraction, independent of Length.
+     * The first sample fills the whole window. The window keeps the full 32 bit samples, so it can follow an
+     * OversampleFilter. The sum of Length samples has to fit into 32 bits.
+     *
+     * @tparam Length Number of samples in the window. Powers of two divide with a shift.
+     */
+    template<uint8_t Length>
+    class MovingAverageFilter {
+        static_assert(Length > 0, "Length has to be at least 1");
+
+    public:
+        static constexpr uint8_t extraBits = 0;
+
+        uint32_t filter(const uint32_t sample) {
+            if (!initialized) {
+                for (auto &value: window) value = sample;
+                sum = sample * Length;
+                initialized = true;
+            } else {
+                sum = sum - window[position] + sample;
+                window[position] = sample;
+            }
+            position = position + 1 < Length ? position + 1 : 0;
+            return sum / Length;
+        }
+
+    private:
+        uint32_t window[Length] = {};
+        uint32_t sum = 0;
+        uint8_t position = 0;
+        bool initialized = false;
+    };
+
+
+    /**
+     * @class OversampleFilter
+     * @brief Oversampling and decimation: 4^ExtraBits samples are summed up and reduced to one value with
+     * ExtraBits more bits of resolution.
+     *
+     * The output is updated every 4^ExtraBits samples and held in between. Note that the output has
+     * 12 + ExtraBits bits for a 12 bit ADC, so the following stages have to accept the wider values. The gain
+     * in resolution requires some noise on the input.
+     *
+     * @tparam ExtraBits Number of additional bits.
+     */
+    template<uint8_t ExtraBits>
+    class OversampleFilter {
+        static_assert((ExtraBits > 0) && (ExtraBits <= 6), "ExtraBits has to be in the range 1..6");
+
+    public:
+        static constexpr uint8_t extraBits = ExtraBits;
+        static constexpr uint16_t samplesPerOutput = 1u << (2 * ExtraBits);
+
+        uint32_t filter(const uint32_t sample) {
+            sum += sample;
+            if (++count >= samplesPerOutput) {
+                output = sum >> ExtraBits;
+                sum = 0;
+                count = 0;
+                initialized = true;
+            }
+            // Until the first decimation, scale the sample, so the output does not start at 0
+            return initialized ? output : sample << ExtraBits;
+        }
+
+    private:
+        uint32_t sum = 0;
+        uint32_t output = 0;
+        uint16_t count = 0;
+        bool initialized = false;
+    };
+
+
+    /**
+     * @class FilterChain
+     * @brief Runs a sample through several filters, from left to right.
+     *
+     * Example: FilterChain<OversampleFilter<1>, ExponentialFilter<3>>
+     *
+     * @tparam Filters The filters. Each has to provide uint32_t filter(uint32_t).
+     */
+    template<typename... Filters>
+    class FilterChain {
+        static constexpr uint8_t sumExtraBits() {
+            uint8_t sum = 0;
+            for (const uint8_t bits: {FilterExtraBits<Filters>::value..., uint8_t{0}}) {
+                if (bits == unknownFilterScale) return unknownFilterScale;
+                sum += bits;
+            }
+            return sum;
+        }
+
+    public:
+        /** The sum of the extra bits of the stages, unknownFilterScale if one of them is not known. */
+        static constexpr uint8_t extraBits = sumExtraBits();
+
+        uint32_t filter(uint32_t sample) {
+            std::apply([&sample](auto &... stage) { ((sample = stage.filter(sample)), ...); }, stages);
+            return sample;
+        }
+
+        /**
+         * @brief Get a stage of the chain, e.g. to inspect its state.
+         */
+        template<std::size_t Index>
+        auto &getStage() { return std::get<Index>(stages); }
+
+    private:
+        std::tuple<Filters...> stages;
+    };
+}
+
+#endif //LIBSMART_STM32GPIO_ANALOGFILTER_HPP
@@ -0,0 +1,162 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32GPIO_ANALOGTRANSFORM_HPP
+#define LIBSMART_STM32GPIO_ANALOGTRANSFORM_HPP
+
+#include <cstdint>
+
+namespace Stm32Gpio {
+    /**
+     * @class AnalogTransform
+     * @brief Converts a raw ADC value into a value in user units, e.g. percent, 0.1 °C or mV.
+     */
+    class AnalogTransform {
+    public:
+        virtual int32_t transform(uint32_t raw) const = 0;
+    };
+
+
+    /**
+     * @brief A straight line through (raw0, value0) with a precomputed slope.
+     *
+     * The result is the exact integer division (value1 - value0) * (raw - raw0) / (raw1 - raw0), that
+     * truncates towards zero. The slope is stored as fixed point number with the largest number of fractional
+     * bits, that fits into 32 bits, and rounded away from zero. Its rounding error stays below one unit as long
+     * as |raw - raw0| <= exactDelta, then one multiply and one shift give the exact result. Further away from
+     * raw0, which only happens with very steep lines, the division is done.
+     */
+    struct LinearSegment {
+        uint32_t raw0 = 0;
+        int32_t value0 = 0;
+        int32_t slope = 0;
+        uint8_t shift = 0;
+        bool negative = false;
+        uint32_t magnitude = 0;
+        uint32_t divisor = 0;
+
+        /** The largest distance from raw0, for which the fixed point slope is exact. */
+        uint32_t exactDelta = UINT32_MAX;
+
+        constexpr LinearSegment() = default;
+
+        constexpr LinearSegment(const uint32_t raw0, const int32_t value0, const uint32_t raw1, const int32_t value1)
+            : raw0(raw0), value0(value0) {
+            const int64_t rise = static_cast<int64_t>(value1) - value0;
+            const int64_t run = static_cast<int64_t>(raw1) - raw0;
+            magnitude = static_cast<uint32_t>(rise < 0 ? -rise : rise);
+            divisor = static_cast<uint32_t>(run < 0 ? -run : run);
+            negative = (rise < 0) != (run < 0);
+            // A vertical line stays at value0
+            if (divisor == 0) return;
+
+            shift = 32;
+            while ((shift > 0) && (((static_cast<uint64_t>(magnitude) << shift) + divisor - 1) / divisor > INT32_MAX)) {
+                shift--;
+            }
+            const uint64_t scaled = ((static_cast<uint64_t>(magnitude) << shift) + divisor - 1) / divisor;
+            slope = negative ? -static_cast<int32_t>(scaled) : static_cast<int32_t>(scaled);
+
+            // The slope exceeds the exact one by error / (divisor * 2^shift). Multiplied by delta, this has to
+            // stay below 1 / divisor, so the truncated result does not reach the next integer.
+            const uint64_t error = scaled * divisor - (static_cast<uint64_t>(magnitude) << shift);
+            const uint64_t limit = error == 0 ? UINT32_MAX : ((1ull << shift) - 1) / error;
+            exactDelta = static_cast<uint32_t>(limit < UINT32_MAX ? limit : UINT32_MAX);
+        }
+
+        /**
+         * @brief Evaluate the line, usually with one multiply and one shift.
+         */
+        constexpr int32_t evaluate(const uint32_t raw) const {
+            const int64_t delta = static_cast<int64_t>(raw) - raw0;
+            const uint64_t distance = static_cast<uint64_t>(delta < 0 ? -delta : delta);
+            if (distance > exactDelta) {
+                // Truncate towards zero, like an integer division
+                const auto quotient = static_cast<int64_t>(distance * magnitude / divisor);
+                return value0 + static_cast<int32_t>(negative != (delta < 0) ? -quotient : quotient);
+            }
+            const int64_t product = delta * slope;
+            const int64_t scaled = product < 0 ? -((-product) >> shift) : product >> shift;
+            return value0 + static_cast<int32_t>(scaled);
+        }
+    };
+
+
+    /**
+     * @class LinearTransform
+     * @brief Linear scale and offset through two calibration points, with optional clamping.
+     *
+     * Example: 4..20 mA on a 165 Ohm shunt to 0..100 % with 12 bit: LinearTransform(819, 0, 4096, 110)
+     */
+    class LinearTransform : public AnalogTransform {
+    public:
+        /**
+         * @param raw0 Raw value of the first calibration point.
+         * @param value0 Value in user units at raw0.
+         * @param raw1 Raw value of the second calibration point.
+         * @param value1 Value in user units at raw1.
+         * @param minValue Lower clamp limit.
+         * @param maxValue Upper clamp limit.
+         */
+        constexpr LinearTransform(const uint32_t raw0, const int32_t value0, const uint32_t raw1,
+                                  const int32_t value1, const int32_t minValue = INT32_MIN,
+                                  const int32_t maxValue = INT32_MAX)
+            : segment(raw0, value0, raw1, value1), minValue(minValue), maxValue(maxValue) {
+        }
+
+        int32_t transform(const uint32_t raw) const override {
+            const int32_t value = segment.evaluate(raw);
+            return value < minValue ? minValue : (value > maxValue ? maxValue : value);
+        }
+
+    private:
+        LinearSegment segment;
+        int32_t minValue;
+        int32_t maxValue;
+    };
+
+
+    /**
+     * @class PiecewiseLinearTransform
+     * @brief Interpolates linearly between calibration points, e.g. the table of an NTC thermistor.
+     *
+     * The slopes of all segments are precomputed, so a conversion is a search for the segment plus one
+     * multiply and one shift. Outside the table, the value is clamped to the first or the last point.
+     *
+     * @tparam N Number of calibration points, at least 2.
+     */
+    template<uint8_t N>
+    class PiecewiseLinearTransform : public AnalogTransform {
+        static_assert(N >= 2, "At least 2 points are required");
+
+    public:
+        /**
+         * @param raws Raw values of the calibration points, in ascending order.
+         * @param values Values in user units at the calibration points.
+         */
+        constexpr PiecewiseLinearTransform(const uint32_t (&raws)[N], const int32_t (&values)[N]) {
+            for (uint8_t i = 0; i < N - 1; i++) {
+                segments[i] = LinearSegment(raws[i], values[i], raws[i + 1], values[i + 1]);
+            }
+            lastRaw = raws[N - 1];
+            lastValue = values[N - 1];
+        }
+
+        int32_t transform(const uint32_t raw) const override {
+            if (raw <= segments[0].raw0) return segments[0].value0;
+            if (raw >= lastRaw) return lastValue;
+            uint8_t i = N - 2;
+            while (raw < segments[i].raw0) i--;
+            return segments[i].evaluate(raw);
+        }
+
+    private:
+        LinearSegment segments[N - 1] = {};
+        uint32_t lastRaw = 0;
+        int32_t lastValue = 0;
+    };
+}
+
+#endif //LIBSMART_STM32GPIO_ANALOGTRANSFORM_HPP
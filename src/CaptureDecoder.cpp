@@ -0,0 +1,105 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "CaptureDecoder.hpp"
+
+using namespace Stm32Gpio;
+
+uint16_t CaptureDecoder::extractRuns(const uint16_t mask, CaptureRun *runs, const uint16_t maxRuns) const {
+    if ((sampleCount == 0) || (maxRuns == 0)) return 0;
+
+    uint16_t count = 0;
+    uint16_t value = getSample(0) & mask;
+    runs[count++] = {0, value};
+    for (uint16_t i = 1; (i < sampleCount) && (count < maxRuns); i++) {
+        const uint16_t sample = getSample(i) & mask;
+        if (sample == value) continue;
+        value = sample;
+        runs[count++] = {i, value};
+    }
+    return count;
+}
+
+uint16_t CaptureDecoder::extractEdges(const uint16_t pinMask, bool &initialHigh, uint32_t *edgeSamples,
+                                      const uint16_t maxEdges) const {
+    initialHigh = false;
+    if (sampleCount == 0) return 0;
+
+    bool high = (getSample(0) & pinMask) != 0;
+    initialHigh = high;
+
+    uint16_t count = 0;
+    for (uint16_t i = 1; (i < sampleCount) && (count < maxEdges); i++) {
+        if (((getSample(i) & pinMask) != 0) == high) continue;
+        high = !high;
+        edgeSamples[count++] = i;
+    }
+    return count;
+}
+
+void CaptureDecoder::exportVcd(const char portName, const uint16_t mask, const uint64_t periodTicks,
+                               const uint32_t clockHz, const textWriter writer, void *context) const {
+    // One printable identifier per pin, starting at '!'
+    char text[4] = {};
+
+    writer(context, "$timescale 1 ns $end\n$scope module GPIO");
+    text[0] = portName;
+    text[1] = '\0';
+    writer(context, text);
+    writer(context, " $end\n");
+    for (uint8_t bit = 0; bit < 16; bit++) {
+        if ((mask & (1u << bit)) == 0) continue;
+        writer(context, "$var wire 1 ");
+        text[0] = static_cast<char>('!' + bit);
+        text[1] = ' ';
+        text[2] = 'P';
+        text[3] = '\0';
+        writer(context, text);
+        text[0] = portName;
+        text[1] = '\0';
+        writer(context, text);
+        writeNumber(bit, writer, context);
+        writer(context, " $end\n");
+    }
+    writer(context, "$upscope $end\n$enddefinitions $end\n");
+    if (sampleCount == 0) return;
+
+    uint16_t value = getSample(0) & mask;
+    uint16_t changed = mask;
+    for (uint16_t i = 0; i < sampleCount; i++) {
+        if (i > 0) {
+            const uint16_t sample = getSample(i) & mask;
+            changed = sample ^ value;
+            value = sample;
+        }
+        if (changed == 0) continue;
+
+        writer(context, "#");
+        writeNumber(sampleTimeNs(i, periodTicks, clockHz), writer, context);
+        writer(context, "\n");
+        for (uint8_t bit = 0; bit < 16; bit++) {
+            if ((changed & (1u << bit)) == 0) continue;
+            text[0] = (value & (1u << bit)) != 0 ? '1' : '0';
+            text[1] = static_cast<char>('!' + bit);
+            text[2] = '\n';
+            text[3] = '\0';
+            writer(context, text);
+        }
+    }
+    writer(context, "#");
+    writeNumber(sampleTimeNs(sampleCount, periodTicks, clockHz), writer, context);
+    writer(context, "\n");
+}
+
+void CaptureDecoder::writeNumber(uint64_t value, const textWriter writer, void *context) {
+    char text[21];
+    char *p = &text[sizeof(text) - 1];
+    *p = '\0';
+    do {
+        *--p = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    writer(context, p);
+}
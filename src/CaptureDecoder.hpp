@@ -0,0 +1,129 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32GPIO_CAPTUREDECODER_HPP
+#define LIBSMART_STM32GPIO_CAPTUREDECODER_HPP
+
+#include <cstdint>
+
+namespace Stm32Gpio {
+    /**
+     * @brief A run of identical samples in a capture, as returned by CaptureDecoder::extractRuns().
+     */
+    struct CaptureRun {
+        /** Index of the first sample of the run, counted from the oldest sample. */
+        uint32_t sample;
+        /** Masked value of the port during the run. */
+        uint16_t value;
+    };
+
+    /**
+     * @class CaptureDecoder
+     * @brief Evaluates the samples of a port capture, e.g. of PortCapture.
+     *
+     * The samples are read from a (possibly wrapped) ring buffer of input data register values. The decoder
+     * does not depend on the HAL, so captures can also be evaluated on a host.
+     */
+    class CaptureDecoder {
+    public:
+        /**
+         * @brief Receives the text of exportVcd() piece by piece.
+         */
+        using textWriter = void (*)(void *context, const char *text);
+
+        CaptureDecoder() = delete;
+
+        /**
+         * @param buffer The ring buffer of the samples.
+         * @param length The number of samples in the buffer.
+         * @param firstSample The index of the oldest sample in the buffer.
+         * @param sampleCount The number of valid samples.
+         */
+        CaptureDecoder(const uint16_t *buffer, const uint16_t length, const uint16_t firstSample,
+                       const uint16_t sampleCount)
+            : buffer(buffer), length(length), firstSample(firstSample), sampleCount(sampleCount) {
+        }
+
+        uint16_t getSampleCount() const { return sampleCount; }
+
+        /**
+         * @brief Get a sample.
+         *
+         * @param index The index of the sample, 0 is the oldest sample.
+         * @return The value of the input data register.
+         */
+        uint16_t getSample(const uint16_t index) const {
+            const uint32_t i = static_cast<uint32_t>(firstSample) + index;
+            return buffer[i < length ? i : i - length];
+        }
+
+        /**
+         * @brief Compress the samples into runs of identical values.
+         *
+         * The first run starts at sample 0, every further run starts at a change of the masked port value.
+         *
+         * @param mask The pins to evaluate, e.g. GPIO_PIN_0 | GPIO_PIN_3.
+         * @param runs Receives the runs.
+         * @param maxRuns Size of the runs array.
+         * @return The number of runs. If it equals maxRuns, the capture may have more runs.
+         */
+        uint16_t extractRuns(uint16_t mask, CaptureRun *runs, uint16_t maxRuns) const;
+
+        /**
+         * @brief Decode the edges of a single pin.
+         *
+         * @param pinMask The mask of the pin, e.g. GPIO_PIN_3.
+         * @param initialHigh Receives the level of the pin at sample 0.
+         * @param edgeSamples Receives the sample index of each edge.
+         * @param maxEdges Size of the edgeSamples array.
+         * @return The number of edges.
+         */
+        uint16_t extractEdges(uint16_t pinMask, bool &initialHigh, uint32_t *edgeSamples, uint16_t maxEdges) const;
+
+        /**
+         * @brief Export the samples as value change dump (VCD).
+         *
+         * The pins are named after the port and pin number, e.g. PB5. The timestamps are in nanoseconds. Each
+         * timestamp is calculated from the sample index and the exact sample period, so the rounding error
+         * does not accumulate over the capture.
+         *
+         * @param portName The letter of the port, e.g. 'B'.
+         * @param mask The pins to export.
+         * @param periodTicks The sample period in ticks of the timer clock.
+         * @param clockHz The timer clock.
+         * @param writer Receives the text.
+         * @param context Passed to the writer.
+         */
+        void exportVcd(char portName, uint16_t mask, uint64_t periodTicks, uint32_t clockHz, textWriter writer,
+                       void *context) const;
+
+        /**
+         * @brief Get the time of a sample.
+         *
+         * @param index The index of the sample.
+         * @param periodTicks The sample period in ticks of the timer clock.
+         * @param clockHz The timer clock.
+         * @return The time since sample 0 in nanoseconds, rounded down.
+         */
+        static uint64_t sampleTimeNs(const uint32_t index, const uint64_t periodTicks, const uint32_t clockHz) {
+            // Split into whole seconds and the remainder, so the product does not overflow
+            const uint64_t ticks = index * periodTicks;
+            return (ticks / clockHz) * 1000000000ull + (ticks % clockHz) * 1000000000ull / clockHz;
+        }
+
+    private:
+        /**
+         * @brief Write an unsigned number as decimal text.
+         */
+        static void writeNumber(uint64_t value, textWriter writer, void *context);
+
+        const uint16_t *buffer;
+        uint16_t length;
+        uint16_t firstSample;
+        uint16_t sampleCount;
+    };
+}
+
+#endif //LIBSMART_STM32GPIO_CAPTUREDECODER_HPP
@@ -0,0 +1,156 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32GPIO_EDGEEVENTRING_HPP
+#define LIBSMART_STM32GPIO_EDGEEVENTRING_HPP
+
+#include <atomic>
+#include <cstdint>
+
+namespace Stm32Gpio {
+    /**
+     * @brief A single edge of an input pin.
+     */
+    struct EdgeEvent {
+        /** Time of the edge, as returned by TimeBase::capture(). */
+        uint32_t timestamp;
+        uint8_t pinIndex;
+        uint8_t level;
+    };
+
+    using edgeEventOverflowPolicyType = enum class edgeEventOverflowPolicyType {
+        /** Discard the event, that does not fit into the ring. */
+        DROP_NEWEST,
+        /** Discard the oldest event in the ring, to make room for the new one. */
+        DROP_OLDEST
+    };
+
+    /**
+     * @class EdgeEventRing
+     * @brief Lock-free single producer / single consumer ring buffer for edge events.
+     *
+     * The producer (usually an interrupt handler) calls push(), the consumer (usually loop()) calls pop()
+     * or popBatch(). Neither side disables interrupts. The head index is only written by the producer.
+     * The tail index is only written by the consumer, except for the DROP_OLDEST policy, where both sides
+     * advance it with compare-and-swap. A consumer, that loses this race, discards its copy and retries.
+     *
+     * @tparam Capacity Number of events in the ring. Has to be a power of two.
+     * @tparam Policy What to do, if the ring is full.
+     */
+    template<uint16_t Capacity, edgeEventOverflowPolicyType Policy = edgeEventOverflowPolicyType::DROP_NEWEST>
+    class EdgeEventRing {
+        static_assert((Capacity != 0) && ((Capacity & (Capacity - 1)) == 0), "Capacity has to be a power of two");
+
+    public:
+        /**
+         * @brief Add an event to the ring. Must only be called by the producer.
+         *
+         * @param event The event to add.
+         * @return true if the event was added without dropping another one, false otherwise.
+         */
+        bool push(const EdgeEvent &event) {
+            const uint32_t h = head.load(std::memory_order_relaxed);
+            uint32_t t = tail.load(std::memory_order_acquire);
+            bool dropped = false;
+
+            if ((h - t) >= Capacity) {
+                if (Policy == edgeEventOverflowPolicyType::DROP_NEWEST) {
+                    countOverflow();
+                    return false;
+                }
+                // If the exchange fails, the consumer has just made room
+                dropped = tail.compare_exchange_strong(t, t + 1, std::memory_order_acq_rel);
+                if (dropped) countOverflow();
+            }
+
+            buffer[h & mask] = event;
+            head.store(h + 1, std::memory_order_release);
+
+            const uint32_t used = h + 1 - t - (dropped ? 1 : 0);
+            if (used > highWater.load(std::memory_order_relaxed)) {
+                highWater.store(used, std::memory_order_relaxed);
+            }
+            return !dropped;
+        }
+
+        /**
+         * @brief Take the oldest event from the ring. Must only be called by the consumer.
+         *
+         * @param event Receives the event.
+         * @return true if an event was taken, false if the ring is empty.
+         */
+        bool pop(EdgeEvent &event) {
+            return popBatch(&event, 1) == 1;
+        }
+
+        /**
+         * @brief Take up to maxEvents events from the ring. Must only be called by the consumer.
+         *
+         * @param events Receives the events, oldest first.
+         * @param maxEvents Size of the events array.
+         * @return The number of events taken.
+         */
+        uint16_t popBatch(EdgeEvent *events, const uint16_t maxEvents) {
+            if (Policy == edgeEventOverflowPolicyType::DROP_NEWEST) {
+                const uint32_t t = tail.load(std::memory_order_relaxed);
+                const uint32_t available = head.load(std::memory_order_acquire) - t;
+                const uint16_t count = available < maxEvents ? static_cast<uint16_t>(available) : maxEvents;
+                for (uint16_t i = 0; i < count; i++) {
+                    events[i] = buffer[(t + i) & mask];
+                }
+                tail.store(t + count, std::memory_order_release);
+                return count;
+            }
+
+            uint16_t count = 0;
+            while (count < maxEvents) {
+                uint32_t t = tail.load(std::memory_order_acquire);
+                if (t == head.load(std::memory_order_acquire)) break;
+                events[count] = buffer[t & mask];
+                if (tail.compare_exchange_strong(t, t + 1, std::memory_order_acq_rel)) count++;
+            }
+            return count;
+        }
+
+        /**
+         * @brief Get the number of events in the ring.
+         */
+        uint32_t size() const {
+            return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Check if the ring is empty.
+         */
+        bool isEmpty() const { return size() == 0; }
+
+        /**
+         * @brief Get the maximum number of events, that have been in the ring at the same time.
+         */
+        uint32_t getHighWaterMark() const { return highWater.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Get the number of events, that were dropped because the ring was full.
+         */
+        uint32_t getOverflowCount() const { return overflows.load(std::memory_order_relaxed); }
+
+        static constexpr uint16_t capacity = Capacity;
+
+    private:
+        static constexpr uint32_t mask = Capacity - 1;
+
+        void countOverflow() {
+            overflows.store(overflows.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        EdgeEvent buffer[Capacity] = {};
+        std::atomic<uint32_t> head{0};
+        std::atomic<uint32_t> tail{0};
+        std::atomic<uint32_t> highWater{0};
+        std::atomic<uint32_t> overflows{0};
+    };
+}
+
+#endif //LIBSMART_STM32GPIO_EDGEEVENTRING_HPP
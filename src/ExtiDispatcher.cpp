@@ -0,0 +1,89 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "ExtiDispatcher.hpp"
+
+#if defined(LIBSMART_STM32GPIO_ENABLE_EXTI) && defined(HAL_EXTI_MODULE_ENABLED)
+
+#include "PinDigitalIn.hpp"
+
+using namespace Stm32Gpio;
+
+PinDigitalIn *ExtiDispatcher::lines[16] = {};
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_EDGE_EVENT_RING
+ExtiDispatcher::eventRingType ExtiDispatcher::events;
+uint32_t ExtiDispatcher::handledOverflows = 0;
+
+void ExtiDispatcher::drainEvents() {
+    // Overflows after this point are handled by the next call
+    const uint32_t overflows = events.getOverflowCount();
+
+    EdgeEvent batch[LIBSMART_STM32GPIO_EDGE_EVENT_BATCH_SIZE];
+    uint16_t count;
+    while ((count = events.popBatch(batch, LIBSMART_STM32GPIO_EDGE_EVENT_BATCH_SIZE)) != 0) {
+        for (uint16_t i = 0; i < count; i++) {
+            PinDigitalIn *pin = lines[batch[i].pinIndex];
+            pin != nullptr ? pin->handleEdgeEvent(batch[i]) : (void) nullptr;
+        }
+    }
+
+    if (overflows == handledOverflows) return;
+    handledOverflows = overflows;
+    for (PinDigitalIn *pin: lines) {
+        pin != nullptr ? pin->handleEventOverflow() : (void) nullptr;
+    }
+}
+#endif
+
+bool ExtiDispatcher::attach(const uint8_t line, PinDigitalIn *pin) {
+    if ((lines[line] != nullptr) && (lines[line] != pin)) return false;
+    lines[line] = pin;
+    return true;
+}
+
+void ExtiDispatcher::detach(const uint8_t line) {
+    lines[line] = nullptr;
+}
+
+void ExtiDispatcher::dispatch(const uint32_t lineMask) {
+    uint32_t pending = EXTI->PR & EXTI->IMR & lineMask;
+    EXTI->PR = pending;
+    while (pending != 0) {
+        const uint8_t line = 31u - __CLZ(pending);
+        pending &= ~(1u << line);
+        PinDigitalIn *pin = lines[line];
+        pin != nullptr ? pin->handleInterrupt() : (void) nullptr;
+    }
+}
+
+IRQn_Type ExtiDispatcher::getIrqn(const uint8_t line) {
+    switch (line) {
+        case 0: return EXTI0_IRQn;
+        case 1: return EXTI1_IRQn;
+        case 2: return EXTI2_IRQn;
+        case 3: return EXTI3_IRQn;
+        case 4: return EXTI4_IRQn;
+        default: return line < 10 ? EXTI9_5_IRQn : EXTI15_10_IRQn;
+    }
+}
+
+void Stm32Gpio_EXTI_IRQHandler(const uint32_t lineMask) {
+    ExtiDispatcher::dispatch(lineMask);
+}
+
+#ifdef LIBSMART_STM32GPIO_DEFINE_EXTI_IRQ_HANDLERS
+extern "C" {
+    void EXTI0_IRQHandler() { ExtiDispatcher::dispatch(1u << 0); }
+    void EXTI1_IRQHandler() { ExtiDispatcher::dispatch(1u << 1); }
+    void EXTI2_IRQHandler() { ExtiDispatcher::dispatch(1u << 2); }
+    void EXTI3_IRQHandler() { ExtiDispatcher::dispatch(1u << 3); }
+    void EXTI4_IRQHandler() { ExtiDispatcher::dispatch(1u << 4); }
+    void EXTI9_5_IRQHandler() { ExtiDispatcher::dispatch(ExtiDispatcher::LINES_9_5); }
+    void EXTI15_10_IRQHandler() { ExtiDispatcher::dispatch(ExtiDispatcher::LINES_15_10); }
+}
+#endif
+
+#endif
@@ -0,0 +1,145 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32GPIO_EXTIDISPATCHER_HPP
+#define LIBSMART_STM32GPIO_EXTIDISPATCHER_HPP
+
+#include "libsmart_config.hpp"
+#include <main.h>
+#include <cstdint>
+
+#if defined(LIBSMART_STM32GPIO_ENABLE_EXTI) && defined(HAL_EXTI_MODULE_ENABLED)
+
+/**
+ * Preemption priority of the EXTI interrupts, that are enabled by PinDigitalIn::enableInterrupt().
+ */
+#ifndef LIBSMART_STM32GPIO_EXTI_IRQ_PRIORITY
+#define LIBSMART_STM32GPIO_EXTI_IRQ_PRIORITY 5
+#endif
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_EDGE_EVENT_RING
+#include "EdgeEventRing.hpp"
+
+/**
+ * Number of edge events, the ring buffer can hold. Has to be a power of two.
+ */
+#ifndef LIBSMART_STM32GPIO_EDGE_EVENT_RING_SIZE
+#define LIBSMART_STM32GPIO_EDGE_EVENT_RING_SIZE 32
+#endif
+
+/**
+ * What to do, if the ring buffer is full (DROP_NEWEST or DROP_OLDEST).
+ */
+#ifndef LIBSMART_STM32GPIO_EDGE_EVENT_RING_POLICY
+#define LIBSMART_STM32GPIO_EDGE_EVENT_RING_POLICY DROP_NEWEST
+#endif
+
+/**
+ * Number of edge events, that are taken from the ring buffer at once.
+ */
+#ifndef LIBSMART_STM32GPIO_EDGE_EVENT_BATCH_SIZE
+#define LIBSMART_STM32GPIO_EDGE_EVENT_BATCH_SIZE 8
+#endif
+#endif
+
+namespace Stm32Gpio {
+    class PinDigitalIn;
+
+    /**
+     * @class ExtiDispatcher
+     * @brief Routes EXTI interrupts to the PinDigitalIn, that owns the EXTI line.
+     *
+     * Each of the 16 GPIO EXTI lines can be owned by one pin. dispatch() clears the pending lines of the
+     * given group and scans the remaining bits with CLZ, so the cost depends on the number of pending
+     * lines only and not on the number of lines sharing a vector (EXTI9_5, EXTI15_10).
+     *
+     * Call Stm32Gpio_EXTI_IRQHandler() with the lines of the vector from the EXTIx_IRQHandler functions,
+     * or define LIBSMART_STM32GPIO_DEFINE_EXTI_IRQ_HANDLERS to let the library define them.
+     */
+    class ExtiDispatcher {
+    public:
+        ExtiDispatcher() = delete;
+
+        static constexpr uint32_t LINES_9_5 = 0x03E0u;
+        static constexpr uint32_t LINES_15_10 = 0xFC00u;
+
+        /**
+         * @brief Assign an EXTI line to a pin.
+         *
+         * @param line The EXTI line (0..15).
+         * @param pin The pin, that handles the interrupts of this line.
+         * @return true on success, false if the line is already owned by another pin.
+         */
+        static bool attach(uint8_t line, PinDigitalIn *pin);
+
+        /**
+         * @brief Release an EXTI line.
+         *
+         * @param line The EXTI line (0..15).
+         */
+        static void detach(uint8_t line);
+
+        /**
+         * @brief Handle the pending EXTI lines.
+         *
+         * This method has to be called in interrupt context.
+         *
+         * @param lineMask The lines handled by the interrupt vector, e.g. LINES_9_5.
+         */
+        static void dispatch(uint32_t lineMask);
+
+        /**
+         * @brief Get the interrupt number of the vector, that serves an EXTI line.
+         *
+         * @param line The EXTI line (0..15).
+         * @return The interrupt number.
+         */
+        static IRQn_Type getIrqn(uint8_t line);
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_EDGE_EVENT_RING
+        using eventRingType = EdgeEventRing<LIBSMART_STM32GPIO_EDGE_EVENT_RING_SIZE,
+            edgeEventOverflowPolicyType::LIBSMART_STM32GPIO_EDGE_EVENT_RING_POLICY>;
+
+        /**
+         * @brief Queue an edge event. Must only be called in interrupt context.
+         *
+         * @param event The edge event, pinIndex is the EXTI line.
+         */
+        static void pushEvent(const EdgeEvent &event) { events.push(event); }
+
+        /**
+         * @brief Deliver all queued edge events to their pins, in batches.
+         *
+         * If the ring dropped events since the last call, the last edge of a pin may be lost, and interrupt
+         * mode pins do not read the port themselves. So all attached pins are read from the port afterwards.
+         *
+         * This method is called by PinManager::loopAll() in loop context.
+         */
+        static void drainEvents();
+
+        /**
+         * @brief Get the event ring, e.g. to read its high water mark and overflow counters.
+         */
+        static const eventRingType &getEventRing() { return events; }
+#endif
+
+    private:
+        static PinDigitalIn *lines[16];
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_EDGE_EVENT_RING
+        static eventRingType events;
+
+        /**
+         * @brief The overflow count of the ring, that has been handled by drainEvents().
+         */
+        static uint32_t handledOverflows;
+#endif
+    };
+}
+
+extern "C" void Stm32Gpio_EXTI_IRQHandler(uint32_t lineMask);
+
+#endif
+#endif //LIBSMART_STM32GPIO_EXTIDISPATCHER_HPP
@@ -0,0 +1,46 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32GPIO_GPIOPORT_HPP
+#define LIBSMART_STM32GPIO_GPIOPORT_HPP
+
+#include "libsmart_config.hpp"
+#include <main.h>
+#include <cstdint>
+
+/**
+ * Number of GPIO ports, that can be tracked by the per-port facilities (GPIOA .. GPIOK).
+ */
+#ifndef LIBSMART_STM32GPIO_PORT_COUNT
+#define LIBSMART_STM32GPIO_PORT_COUNT 11
+#endif
+
+namespace Stm32Gpio {
+    /**
+     * @class GpioPort
+     * @brief Helpers to map a GPIO port register to a zero based port index.
+     *
+     * The GPIO ports of the STM32 families are laid out in a contiguous block with a fixed stride,
+     * starting at GPIOA. This allows per-port state to be kept in plain arrays.
+     */
+    class GpioPort {
+    public:
+        GpioPort() = delete;
+
+        static constexpr uint8_t count = LIBSMART_STM32GPIO_PORT_COUNT;
+
+        /**
+         * @brief Get the zero based index of a GPIO port.
+         *
+         * @param GPIOx Pointer to the GPIO port register.
+         * @return 0 for GPIOA, 1 for GPIOB and so on.
+         */
+        static uint8_t index(const GPIO_TypeDef *GPIOx) {
+            return static_cast<uint8_t>((reinterpret_cast<uintptr_t>(GPIOx) - GPIOA_BASE) / (GPIOB_BASE - GPIOA_BASE));
+        }
+    };
+}
+
+#endif //LIBSMART_STM32GPIO_GPIOPORT_HPP
@@ -0,0 +1,201 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32GPIO_INPLACEFUNCTION_HPP
+#define LIBSMART_STM32GPIO_INPLACEFUNCTION_HPP
+
+#include "libsmart_config.hpp"
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Default capacity in bytes of an InplaceFunction, e.g. enough for a lambda, that captures two pointers.
+ */
+#ifndef LIBSMART_STM32GPIO_INPLACE_FUNCTION_CAPACITY
+#define LIBSMART_STM32GPIO_INPLACE_FUNCTION_CAPACITY (2 * sizeof(void *))
+#endif
+
+namespace Stm32Gpio {
+    template<typename Signature, size_t Capacity = LIBSMART_STM32GPIO_INPLACE_FUNCTION_CAPACITY>
+    class InplaceFunction;
+
+    /**
+     * @class InplaceFunction
+     * @brief A callable wrapper like std::function, that stores the callable inside the object.
+     *
+     * The callable (a lambda, a functor or a function pointer) is copied into a buffer of Capacity bytes.
+     * A callable, that does not fit, is rejected at compile time, so the wrapper never allocates. Besides the
+     * buffer, the wrapper holds the pointer to the function, that invokes the stored type, so a call costs a
+     * single indirect call, and a pointer to a constant table of the copy, move and destroy operations. Trivially
+     * copyable callables, like lambdas capturing pointers, have no table: they are copied with memcpy and need no
+     * destructor. The arguments are passed on to the stored callable as declared in the signature, so scalars
+     * stay in registers, where std::function passes them by reference.
+     *
+     * An InplaceFunction is empty, if it is default constructed, assigned nullptr or constructed from a null
+     * function pointer. Calling an empty InplaceFunction is undefined, check it against nullptr first.
+     *
+     * @tparam R The return type.
+     * @tparam Args The argument types.
+     * @tparam Capacity The size of the buffer in bytes.
+     */
+    template<typename R, typename... Args, size_t Capacity>
+    class InplaceFunction<R(Args...), Capacity> {
+    public:
+        InplaceFunction() = default;
+
+        InplaceFunction(std::nullptr_t) {
+        }
+
+        template<typename F, typename Fn = std::decay_t<F>,
+            typename = std::enable_if_t<!std::is_same<Fn, InplaceFunction>::value
+                                        && std::is_invocable_r<R, Fn &, Args...>::value> >
+        InplaceFunction(F &&f) {
+            static_assert(sizeof(Fn) <= Capacity, "callable does not fit into the InplaceFunction");
+            static_assert(alignof(Fn) <= alignof(Storage), "callable needs a stronger alignment");
+            // Like std::function, a null function pointer results in an empty wrapper
+            if constexpr (std::is_pointer<std::remove_reference_t<F> >::value) {
+                if (static_cast<Fn>(f) == nullptr) return;
+            }
+            ::new(static_cast<void *>(&storage)) Fn(std::forward<F>(f));
+            invoker = &invoke<Fn>;
+            operations = operationsFor<Fn>();
+        }
+
+        InplaceFunction(const InplaceFunction &other) : invoker(other.invoker), operations(other.operations) {
+            copyFrom(other);
+        }
+
+        InplaceFunction(InplaceFunction &&other) noexcept : invoker(other.invoker), operations(other.operations) {
+            moveFrom(other);
+        }
+
+        ~InplaceFunction() { reset(); }
+
+        InplaceFunction &operator=(const InplaceFunction &other) {
+            if (this != &other) {
+                reset();
+                invoker = other.invoker;
+                operations = other.operations;
+                copyFrom(other);
+            }
+            return *this;
+        }
+
+        InplaceFunction &operator=(InplaceFunction &&other) noexcept {
+            if (this != &other) {
+                reset();
+                invoker = other.invoker;
+                operations = other.operations;
+                moveFrom(other);
+            }
+            return *this;
+        }
+
+        InplaceFunction &operator=(std::nullptr_t) {
+            reset();
+            return *this;
+        }
+
+        template<typename F, typename = std::enable_if_t<!std::is_same<std::decay_t<F>, InplaceFunction>::value> >
+        InplaceFunction &operator=(F &&f) {
+            return *this = InplaceFunction(std::forward<F>(f));
+        }
+
+        R operator()(Args... args) const {
+            return invoker(&storage, std::forward<Args>(args)...);
+        }
+
+        explicit operator bool() const { return invoker != nullptr; }
+
+        friend bool operator==(const InplaceFunction &fn, std::nullptr_t) { return fn.invoker == nullptr; }
+        friend bool operator==(std::nullptr_t, const InplaceFunction &fn) { return fn.invoker == nullptr; }
+        friend bool operator!=(const InplaceFunction &fn, std::nullptr_t) { return fn.invoker != nullptr; }
+        friend bool operator!=(std::nullptr_t, const InplaceFunction &fn) { return fn.invoker != nullptr; }
+
+    private:
+        struct Storage {
+            alignas(void *) unsigned char bytes[Capacity];
+        };
+
+        using Invoker = R (*)(void *object, Args... args);
+
+        /**
+         * @brief The operations for a stored type, that is not trivially copyable.
+         */
+        struct Operations {
+            void (*copy)(void *dst, const void *src);
+            void (*move)(void *dst, void *src);
+            void (*destroy)(void *object);
+        };
+
+        template<typename Fn>
+        static R invoke(void *object, Args... args) {
+            return (*static_cast<Fn *>(object))(std::forward<Args>(args)...);
+        }
+
+        template<typename Fn>
+        static void copy(void *dst, const void *src) { ::new(dst) Fn(*static_cast<const Fn *>(src)); }
+
+        template<typename Fn>
+        static void move(void *dst, void *src) {
+            ::new(dst) Fn(std::move(*static_cast<Fn *>(src)));
+            static_cast<Fn *>(src)->~Fn();
+        }
+
+        template<typename Fn>
+        static void destroy(void *object) { static_cast<Fn *>(object)->~Fn(); }
+
+        template<typename Fn>
+        static constexpr Operations operationsTable = {&copy<Fn>, &move<Fn>, &destroy<Fn>};
+
+        /**
+         * @brief Get the operations for a stored type, nullptr for trivially copyable types.
+         */
+        template<typename Fn>
+        static constexpr const Operations *operationsFor() {
+            return std::is_trivially_copyable<Fn>::value ? nullptr : &operationsTable<Fn>;
+        }
+
+        void copyFrom(const InplaceFunction &other) {
+            if (operations != nullptr) {
+                operations->copy(&storage, &other.storage);
+            } else {
+                std::memcpy(&storage, &other.storage, sizeof(Storage));
+            }
+        }
+
+        void moveFrom(InplaceFunction &other) {
+            if (operations != nullptr) {
+                operations->move(&storage, &other.storage);
+            } else {
+                std::memcpy(&storage, &other.storage, sizeof(Storage));
+            }
+            other.invoker = nullptr;
+            other.operations = nullptr;
+        }
+
+        void reset() {
+            if (operations != nullptr) operations->destroy(&storage);
+            invoker = nullptr;
+            operations = nullptr;
+        }
+
+        /**
+         * @brief Invokes the stored type, nullptr if the wrapper is empty.
+         */
+        Invoker invoker = nullptr;
+
+        /**
+         * @brief Copies, moves and destroys the stored type, nullptr if it is trivially copyable or empty.
+         */
+        const Operations *operations = nullptr;
+        mutable Storage storage = {};
+    };
+}
+
+#endif //LIBSMART_STM32GPIO_INPLACEFUNCTION_HPP
@@ -22,6 +22,25 @@ uint32_t Pin::millisSinceLastOnChangeCallback() {
     return millis() - lastOnChangeCallbackMs;
 }
 
+uint32_t Pin::millisUntilOnChangeCallback(const bool stateChanged) {
+    uint32_t deferMs = deferOnChangeCallbackMs;
+    if (!stateChanged && (deferForcedOnChangeCallbackMs > deferMs)) deferMs = deferForcedOnChangeCallbackMs;
+    return millisRemaining(millisSinceLastOnChangeCallback(), deferMs);
+}
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_TIMER_WHEEL
+
+void Pin::idleFor(const uint32_t ms) {
+    if ((ms == 0) || (ms == NO_DEADLINE)) {
+        TimerWheel::cancel(wakeTimer);
+    } else {
+        TimerWheel::schedule(wakeTimer, millis() + ms);
+    }
+    if (ms == 0) wakeUp();
+}
+
+#endif
+
 void Pin::setForceOnChangeCallback() {
     setForceOnChangeCallback(0);
 }
@@ -29,3 +48,140 @@ void Pin::setForceOnChangeCallback() {
 void Pin::setDeferOnChangeCallback(const uint32_t deferMs) {
     deferOnChangeCallbackMs = deferMs;
 }
+
+bool Pin::setOnChangeCallback(const onChangeCallback cb) {
+    if (getSubscribers() == nullptr) {
+        onChangeSlot = reinterpret_cast<ChangeSubscription *>(cb);
+        return true;
+    }
+    // The plain callback is the first subscription, if there is one
+    ChangeSubscription *subscription = onChangeSlot;
+    if (subscription->callback == &Pin::callOnChangeCallback) {
+        if (cb == nullptr) return unsubscribe(subscription);
+        subscription->context = reinterpret_cast<void *>(cb);
+        return true;
+    }
+    return (cb == nullptr) || (subscribeOnChangeCallback(cb) != nullptr);
+}
+
+bool Pin::setOnChangeCallback(const onChangeContextCallback cb, void *context) {
+    for (ChangeSubscription *subscription = getSubscribers(); subscription != nullptr;) {
+        // The plain callback is the head of the list, so the list is never moved back into the pin before the
+        // last subscription has been visited
+        ChangeSubscription *next = subscription->next;
+        if (subscription->callback != &Pin::callOnChangeCallback) unsubscribe(subscription);
+        subscription = next;
+    }
+    return (cb == nullptr) || (subscribe(cb, context) != nullptr);
+}
+
+ChangeSubscription *Pin::subscribe(const onChangeContextCallback cb, void *context, const uint8_t priority) {
+    const onChangeCallback inlineCallback = getOnChangeCallback();
+    if (inlineCallback != nullptr) {
+        // The plain callback leaves the pin for a subscription of its own
+        if (SubscriptionPool::getFreeCount() < 2) return nullptr;
+        onChangeSlot = nullptr;
+        subscribeOnChangeCallback(inlineCallback);
+    }
+    ChangeSubscription *subscription = SubscriptionPool::allocate();
+    if (subscription == nullptr) return nullptr;
+    subscription->callback = cb;
+    subscription->context = context;
+    subscription->priority = priority;
+
+    ChangeSubscription **link = &onChangeSlot;
+    while ((*link != nullptr) && ((*link)->priority >= priority)) {
+        link = &(*link)->next;
+    }
+    subscription->next = *link;
+    *link = subscription;
+    return subscription;
+}
+
+bool Pin::unsubscribe(ChangeSubscription *subscription) {
+    if (getSubscribers() == nullptr) return false;
+    for (ChangeSubscription **link = &onChangeSlot; *link != nullptr; link = &(*link)->next) {
+        if (*link != subscription) continue;
+        if (SubscriptionPool::isDispatching()) {
+            // The dispatch may be walking this list, release the subscription afterwards
+            SubscriptionPool::cancel(subscription);
+        } else {
+            *link = subscription->next;
+            SubscriptionPool::release(subscription);
+            inlineOnChangeCallback();
+        }
+        return true;
+    }
+    return false;
+}
+
+void Pin::notifySubscribers(const PinEvent &event) {
+    SubscriptionPool::beginDispatch();
+    for (const ChangeSubscription *subscription = onChangeSlot; subscription != nullptr;
+         subscription = subscription->next) {
+        subscription->callback != nullptr ? subscription->callback(subscription->context, this, event) : (void) nullptr;
+    }
+    SubscriptionPool::endDispatch();
+    // The callbacks may have cancelled subscriptions of other pins, too
+    if (!SubscriptionPool::isDispatching() && SubscriptionPool::takeCancelPending()) {
+        PinManager::releaseCancelledSubscriptions();
+    }
+}
+
+void Pin::releaseCancelledSubscriptions() {
+    if (getSubscribers() == nullptr) return;
+    ChangeSubscription **link = &onChangeSlot;
+    while (*link != nullptr) {
+        ChangeSubscription *subscription = *link;
+        if (subscription->callback == nullptr) {
+            *link = subscription->next;
+            SubscriptionPool::release(subscription);
+        } else {
+            link = &subscription->next;
+        }
+    }
+    inlineOnChangeCallback();
+}
+
+ChangeSubscription *Pin::subscribeOnChangeCallback(const onChangeCallback cb) {
+    ChangeSubscription *subscription = SubscriptionPool::allocate();
+    if (subscription == nullptr) return nullptr;
+    subscription->callback = &Pin::callOnChangeCallback;
+    subscription->context = reinterpret_cast<void *>(cb);
+    subscription->priority = UINT8_MAX;
+    // In front of subscribers with the same priority, so it is called first as before
+    subscription->next = onChangeSlot;
+    onChangeSlot = subscription;
+    return subscription;
+}
+
+void Pin::inlineOnChangeCallback() {
+    ChangeSubscription *subscription = getSubscribers();
+    if ((subscription == nullptr) || (subscription->next != nullptr) ||
+        (subscription->callback != &Pin::callOnChangeCallback)) {
+        return;
+    }
+    onChangeSlot = reinterpret_cast<ChangeSubscription *>(reinterpret_cast<onChangeCallback>(subscription->context));
+    SubscriptionPool::release(subscription);
+}
+
+void Pin::callOnChangeCallback(void *context, PinInterface *pin, const PinEvent &) {
+    reinterpret_cast<onChangeCallback>(context)(pin);
+}
+
+bool Pin::isLoopedBefore(const Pin *other) const {
+    const uint8_t order = getLoopOrder();
+    const uint8_t otherOrder = other->getLoopOrder();
+    if (order != otherOrder) return order < otherOrder;
+    return reinterpret_cast<uintptr_t>(GPIOx) < reinterpret_cast<uintptr_t>(other->GPIOx);
+}
+
+uint8_t Pin::getLoopOrder() const {
+    static constexpr uint8_t loopOrder[] = {
+        2, // DIGITAL_OUT
+        0, // DIGITAL_IN
+        3, // PWM_OUT
+        1, // ANALOG_IN
+    };
+    return loopOrder[static_cast<uint8_t>(pinMode)];
+}
@@ -10,53 +10,230 @@
 #include <main.h>
 #include <cstdint>
 #include "PinInterface.hpp"
+#include "PinEvent.hpp"
+#include "SubscriptionPool.hpp"
+#include "PinManager.hpp"
+#include "TimerWheel.hpp"
 #include "Helper.hpp"
 
 #ifdef LIBSMART_ENABLE_STD_FUNCTION
+#ifdef LIBSMART_STM32GPIO_ENABLE_INPLACE_FUNCTION
+#include "InplaceFunction.hpp"
+#else
 #include <functional>
 #endif
+#endif
 
 
 namespace Stm32Gpio {
     class Pin : public PinInterface {
+        friend class PinManager;
+
     public:
         Pin() = delete;
 
+        ~Pin() override {
+#ifdef LIBSMART_STM32GPIO_ENABLE_TIMER_WHEEL
+            TimerWheel::cancel(wakeTimer);
+#endif
+            PinManager::remove(this);
+            ChangeSubscription *subscription = getSubscribers();
+            while (subscription != nullptr) {
+                ChangeSubscription *next = subscription->next;
+                SubscriptionPool::release(subscription);
+                subscription = next;
+            }
+        }
+
+        /**
+         * @brief Returned by millisUntilNextDeadline(), if the pin has no deadline.
+         */
+        static constexpr uint32_t NO_DEADLINE = UINT32_MAX;
+
         void setup() override;
 
         void loop() override;;
 
+        /**
+         * @brief Check if the pin has no pending work.
+         *
+         * An idle pin is skipped by PinManager::loopAll(), until something wakes it up again (e.g. a new
+         * output state, a forced onChange callback or a loop callback).
+         *
+         * @return true if calling loop() would do nothing, false otherwise.
+         */
+        bool isLoopIdle() const { return loopIdle; }
+
+        /**
+         * @brief Get the GPIO port register of the pin.
+         *
+         * @return Pointer to the GPIO port register, nullptr for pins without a GPIO (e.g. analog inputs).
+         */
+        GPIO_TypeDef *getPort() const { return GPIOx; }
+
+        /**
+         * @brief Get the GPIO pin mask of the pin.
+         *
+         * @return The GPIO_PIN_x mask.
+         */
+        uint16_t getPinMask() const { return GPIO_Pin; }
+
     protected:
         Pin(GPIO_TypeDef *GPIOx, const uint16_t GPIO_Pin, const pinModeType pinMode)
             : PinInterface(pinMode),
               GPIOx(GPIOx),
               GPIO_Pin(GPIO_Pin) {
+            PinManager::add(this);
         }
 
         Pin(const char *pinName, GPIO_TypeDef *GPIOx, const uint16_t GPIO_Pin, const pinModeType pinMode)
             : PinInterface(pinName, pinMode),
               GPIOx(GPIOx),
               GPIO_Pin(GPIO_Pin) {
+            PinManager::add(this);
         }
 
     public:
         using onChangeCallback = void (*)(PinInterface *pin);
         using loopCallback = void (*)(PinInterface *pin);
-        virtual void setOnChangeCallback(const onChangeCallback cb) { cb_onChange = cb; }
-        virtual void setLoopCallback(const loopCallback cb) { cb_loop = cb; }
+
+        /**
+         * @brief Set the plain onChange callback of the pin.
+         *
+         * The callback is called before all subscribers and is not touched by subscribe() and unsubscribe().
+         * As long as the pin has no subscribers, the callback is stored in the pin itself. Otherwise it takes a
+         * subscription from the SubscriptionPool, too.
+         *
+         * @param cb The callback, nullptr to remove it.
+         * @return true on success, false if the pin has subscribers and the SubscriptionPool is exhausted.
+         */
+        virtual bool setOnChangeCallback(onChangeCallback cb);
+
+        virtual void setLoopCallback(const loopCallback cb) {
+            cb_loop = cb;
+            wakeUp();
+        }
+
+        using onChangeContextCallback = ChangeSubscription::callbackType;
+
+        /**
+         * @brief Set an onChange callback, that receives a user context and the latched change.
+         *
+         * The event carries the new state, the edge, the time of the change and the time since the previous
+         * change, as they were latched by the pin. So the callback does not need to read the pin again.
+         *
+         * This replaces all subscriptions of the pin by a single one, see subscribe(). The plain onChange
+         * callback is kept.
+         *
+         * @param cb The callback, nullptr to remove all subscriptions.
+         * @param context A user pointer, that is passed to the callback, e.g. the object handling the change.
+         * @return true on success, false if the SubscriptionPool is exhausted and the callback is not set.
+         */
+        virtual bool setOnChangeCallback(onChangeContextCallback cb, void *context);
+
+        /**
+         * @brief Add an onChange subscriber to the pin.
+         *
+         * Any number of subscribers can listen to the same pin. They are called in the order of their priority,
+         * subscribers with the same priority in the order they subscribed. The subscriptions are taken from the
+         * static SubscriptionPool, sized by LIBSMART_STM32GPIO_SUBSCRIPTION_POOL_SIZE. If the pin has a plain
+         * onChange callback, the first subscriber takes a second subscription for it.
+         *
+         * @param cb The callback.
+         * @param context A user pointer, that is passed to the callback.
+         * @param priority Subscribers with a higher priority are called first.
+         * @return The subscription, that is needed to unsubscribe, nullptr if the pool is exhausted.
+         */
+        ChangeSubscription *subscribe(onChangeContextCallback cb, void *context, uint8_t priority = 0);
+
+        /**
+         * @brief Remove an onChange subscriber from the pin.
+         *
+         * This may be called from within an onChange callback, even for the subscription, that is being called.
+         * The subscriber is not called anymore, and its subscription is returned to the pool after the dispatch.
+         *
+         * @param subscription The subscription, as returned by subscribe().
+         * @return true on success, false if the subscription does not belong to the pin.
+         */
+        bool unsubscribe(ChangeSubscription *subscription);
 
     private:
-        onChangeCallback cb_onChange = {};
+        /**
+         * @brief Call all subscribers with the given event.
+         */
+        void notifySubscribers(const PinEvent &event);
+
+        /**
+         * @brief Unlink and release the subscriptions, that have been cancelled during a dispatch.
+         *
+         * This is called by PinManager::releaseCancelledSubscriptions() for all pins.
+         */
+        void releaseCancelledSubscriptions();
+
+        /**
+         * @brief Subscribe the plain onChange callback in front of all other subscribers.
+         *
+         * @param cb The plain onChange callback.
+         * @return The subscription, nullptr if the pool is exhausted.
+         */
+        ChangeSubscription *subscribeOnChangeCallback(onChangeCallback cb);
+
+        /**
+         * @brief Move the plain onChange callback back into the pin, if it is the last subscription left.
+         */
+        void inlineOnChangeCallback();
+
+        /**
+         * @brief Calls the plain onChange callback, that is passed as context, see subscribeOnChangeCallback().
+         */
+        static void callOnChangeCallback(void *context, PinInterface *pin, const PinEvent &event);
+
+        /**
+         * @brief Get the head of the subscriber list.
+         *
+         * @return The first subscription, nullptr if the pin has no subscribers.
+         */
+        ChangeSubscription *getSubscribers() const {
+            return SubscriptionPool::owns(onChangeSlot) ? onChangeSlot : nullptr;
+        }
+
+        /**
+         * @brief Get the plain onChange callback, that is stored in the pin itself.
+         *
+         * @return The callback, nullptr if there is none or if the pin has subscribers.
+         */
+        onChangeCallback getOnChangeCallback() const {
+            return SubscriptionPool::owns(onChangeSlot) ? nullptr : reinterpret_cast<onChangeCallback>(onChangeSlot);
+        }
+
         loopCallback cb_loop = {};
 
+        /**
+         * @brief The plain onChange callback or the head of the subscriber list, sorted by priority.
+         *
+         * A pin without subscribers stores its plain onChange callback here. With subscribers, this is the head
+         * of their list, and the plain callback is the first subscription. A subscription always lies within the
+         * SubscriptionPool and a function never does, so SubscriptionPool::owns() tells them apart. So the
+         * onChange callbacks of a pin with zero or one subscriber take a single pointer.
+         */
+        ChangeSubscription *onChangeSlot = nullptr;
+
 
 #ifdef LIBSMART_ENABLE_STD_FUNCTION
 
     public:
+#ifdef LIBSMART_STM32GPIO_ENABLE_INPLACE_FUNCTION
+        using onChangeFunction = InplaceFunction<void()>;
+        using loopFunction = InplaceFunction<void()>;
+#else
         using onChangeFunction = std::function<void()>;
         using loopFunction = std::function<void()>;
+#endif
         virtual void setOnChangeCallback(const onChangeFunction &cb) { fn_onChange = cb; }
-        virtual void setLoopCallback(const loopFunction &fn) { fn_loop = fn; }
+        virtual void setLoopCallback(const loopFunction &fn) {
+            fn_loop = fn;
+            wakeUp();
+        }
 
     private:
         onChangeFunction fn_onChange = {};
@@ -76,6 +253,21 @@ namespace Stm32Gpio {
          */
         virtual uint32_t millisSinceLastOnChangeCallback();
 
+        /**
+         * @brief Get the number of milliseconds, until the pin has work to do without any external event.
+         *
+         * Sub classes extend this with their own deadlines (e.g. the next blink edge or the next analog sample)
+         * and return the earliest one. The base class knows the deadline of a pending forced onChange callback
+         * only. A pin, that has to be polled, returns 0.
+         *
+         * @see PinManager::millisUntilNextDeadline()
+         * @return The number of milliseconds until the next deadline, 0 if the deadline has already passed,
+         * NO_DEADLINE if the pin has no deadline.
+         */
+        virtual uint32_t millisUntilNextDeadline() {
+            return isForcedOnChangeCallbackPending() ? millisUntilOnChangeCallback(false) : NO_DEADLINE;
+        }
+
         /**
          * @brief Set the forceOnChangeCallback to 0 milliseconds.
          *
@@ -108,6 +300,7 @@ namespace Stm32Gpio {
         virtual void setForceOnChangeCallback(const uint32_t deferMs) {
             forceOnChangeCallback = true;
             deferForcedOnChangeCallbackMs = deferMs;
+            wakeUp();
         };
 
         /**
@@ -126,6 +319,76 @@ namespace Stm32Gpio {
             return forceOnChangeCallback && ((millisSinceLastOnChangeCallback()) >= deferForcedOnChangeCallbackMs);
         };
 
+        /**
+         * @brief Check if a forced onChange callback is pending.
+         *
+         * @return true if setForceOnChangeCallback() was called and the callback has not been triggered yet.
+         */
+        bool isForcedOnChangeCallbackPending() const {
+            return forceOnChangeCallback;
+        }
+
+        /**
+         * @brief Check if a loop callback is set.
+         *
+         * @return true if a loop callback has to be called on every loop iteration.
+         */
+        bool hasLoopCallback() const {
+#ifdef LIBSMART_ENABLE_STD_FUNCTION
+            if (fn_loop != nullptr) return true;
+#endif
+            return cb_loop != nullptr;
+        }
+
+        /**
+         * @brief Get the number of milliseconds, until changeHandler() may call the pending onChange callback.
+         *
+         * @param stateChanged true if the state of the pin has changed, false if only a forced onChange callback
+         * is pending.
+         * @return The remaining defer time in milliseconds, 0 if it has already passed.
+         */
+        uint32_t millisUntilOnChangeCallback(bool stateChanged);
+
+        /**
+         * @brief Get the number of milliseconds, until a period has elapsed.
+         *
+         * @param elapsedMs The number of milliseconds, that have already elapsed.
+         * @param periodMs The length of the period in milliseconds.
+         * @return The remaining milliseconds, 0 if the period has already elapsed.
+         */
+        static uint32_t millisRemaining(const uint32_t elapsedMs, const uint32_t periodMs) {
+            return elapsedMs < periodMs ? periodMs - elapsedMs : 0;
+        }
+
+        /**
+         * @brief Let PinManager::loopAll() loop the pin again.
+         *
+         * Everything, that creates new work for the pin, calls this, interrupt handlers included. With
+         * LIBSMART_STM32GPIO_ENABLE_TIMER_WHEEL, a sleeping pin is appended to the awake list of PinManager,
+         * otherwise loopIdle is cleared only.
+         */
+        void wakeUp() {
+#ifdef LIBSMART_STM32GPIO_ENABLE_TIMER_WHEEL
+            if (loopIdle) PinManager::wake(this);
+#else
+            loopIdle = false;
+#endif
+        }
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_TIMER_WHEEL
+        /**
+         * @brief Let the pin sleep, until the given number of milliseconds has passed.
+         *
+         * PinManager::loopAll() takes the pin off its awake list before calling loop(), so the pin sleeps,
+         * unless it is woken up again. Its timer in the TimerWheel is scheduled to wake it up at the deadline.
+         * Sub classes call this at the end of loop() with the result of millisUntilNextDeadline().
+         *
+         * @param ms The number of milliseconds to sleep. 0 keeps the pin awake, NO_DEADLINE lets it sleep until
+         * it is woken up by something else.
+         */
+        void idleFor(uint32_t ms);
+#endif
+
         /**
          * @brief Reset the change tracking variables.
          *
@@ -138,6 +401,20 @@ namespace Stm32Gpio {
             deferOnChangeCallbackMs = 0;
         };
 
+        /**
+         * @brief Describe the change, that is about to be reported by changeHandler().
+         *
+         * This method is called before resetChange(), so sub classes can compare the latched state with the
+         * last reported state. The base class fills in the current time and the time since the last onChange
+         * callback only.
+         *
+         * @param event The event to fill in.
+         */
+        virtual void describeChange(PinEvent &event) {
+            event.timestampMs = millis();
+            event.sincePreviousMs = millisSinceLastOnChangeCallback();
+        }
+
         /**
          * @brief Handle changes in the Pin's state and trigger the onChange callback if necessary.
          *
@@ -147,8 +424,13 @@ namespace Stm32Gpio {
          */
         virtual void changeHandler() {
             if ((millisSinceLastOnChangeCallback() >= deferOnChangeCallbackMs) && hasChanged()) {
+                PinEvent event = {};
+                const bool subscribed = getSubscribers() != nullptr;
+                if (subscribed) describeChange(event);
                 resetChange();
+                const onChangeCallback cb_onChange = getOnChangeCallback();
                 cb_onChange != nullptr ? cb_onChange(this) : (void) nullptr;
+                subscribed ? notifySubscribers(event) : (void) nullptr;
 #ifdef LIBSMART_ENABLE_STD_FUNCTION
                 fn_onChange != nullptr ? fn_onChange() : (void) nullptr;
 #endif
@@ -176,7 +458,62 @@ namespace Stm32Gpio {
          */
         uint16_t GPIO_Pin;
 
+        /**
+         * @brief Indicates whether the pin has no pending work and can be skipped by PinManager::loopAll().
+         *
+         * Sub classes set this flag at the end of loop(), if nothing is left to do. Everything, that creates
+         * new work for the pin, clears it by wakeUp(). As interrupts clear it too, a sub class has to check its
+         * interrupt state again after setting the flag, and wake up, if an interrupt came in between.
+         *
+         * With LIBSMART_STM32GPIO_ENABLE_TIMER_WHEEL, the flag is true, while the pin is not on the awake list
+         * of PinManager. Only loopAll() sets it, when it takes the pin off the list, and sub classes sleep by
+         * idleFor() instead.
+         */
+        volatile bool loopIdle = false;
+
     private:
+        /**
+         * @brief Check if this pin has to be looped before the other pin.
+         *
+         * Inputs are looped before outputs, so outputs can react to inputs within the same loop iteration.
+         * Pins of the same type are grouped by their GPIO port.
+         *
+         * @param other The pin to compare with.
+         * @return true if this pin sorts before the other pin.
+         */
+        bool isLoopedBefore(const Pin *other) const;
+
+        /**
+         * @brief Get the rank of the pin type in the loop order, inputs first.
+         *
+         * @return The rank, less than PinManager::LOOP_ORDERS.
+         */
+        uint8_t getLoopOrder() const;
+
+        /**
+         * @brief The next pin in the list of PinManager.
+         */
+        Pin *nextPin = nullptr;
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_TIMER_WHEEL
+        /**
+         * @brief The next pin in the awake list of PinManager.
+         */
+        Pin *nextAwake = nullptr;
+
+        /**
+         * @brief Wake up the pin, whose timer has expired.
+         *
+         * @param context The pin.
+         */
+        static void expireWakeTimer(void *context) { static_cast<Pin *>(context)->wakeUp(); }
+
+        /**
+         * @brief The timer, that wakes up the pin at its next deadline, see idleFor().
+         */
+        TimerNode wakeTimer{&Pin::expireWakeTimer, this};
+#endif
+
         /**
          * @brief The timestamp in milliseconds of the last onChange callback.
          *
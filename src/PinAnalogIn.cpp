@@ -9,11 +9,106 @@
 
 using namespace Stm32Gpio;
 
+#ifdef HAL_DMA_MODULE_ENABLED
+
+void PinAnalogIn::setup() {
+    Pin::setup();
+    if (scanGroup != nullptr) scanGroup->start();
+}
+
+bool PinAnalogIn::enableWatchdog() {
+    if ((scanGroup == nullptr) || !scanGroup->isRunning()) return false;
+    // The band can not be converted to the range of the ADC
+    if (getFilterExtraBits() == unknownFilterScale) return false;
+    watchdogArmPending = false;
+    watchdogEnabled = armWatchdog();
+    wakeUp();
+    return watchdogEnabled;
+}
+
+void PinAnalogIn::disableWatchdog() {
+    if (!watchdogEnabled) return;
+    scanGroup->releaseWatchdog(this);
+    watchdogEnabled = false;
+    wakeUp();
+}
+
+bool PinAnalogIn::armWatchdog() {
+    // The watchdog compares raw samples. A raw value is out of the band, if its scaled value is.
+    const uint8_t extraBits = getFilterExtraBits();
+    const uint32_t scaledLow = (changeLow + (1u << extraBits) - 1) >> extraBits;
+    const uint32_t scaledHigh = changeHigh >> extraBits;
+
+    // The thresholds are limited to the 12 bit range of the watchdog
+    const uint32_t high = scaledHigh < 0xFFF ? scaledHigh : 0xFFF;
+    const uint32_t low = scaledLow < high ? scaledLow : high;
+    return scanGroup->armWatchdog(this, scanIndex, low, high);
+}
+
+#endif
+
 void PinAnalogIn::loop() {
-    currentAdcValueReady = false;
+    bool sampleDue = (sampleIntervalMs == 0) || ((millis() - lastSampleMs) >= sampleIntervalMs);
+#ifdef HAL_DMA_MODULE_ENABLED
+    sampleDue = sampleDue || watchdogEnabled;
+#endif
+    if (sampleDue) {
+        lastSampleMs = millis();
+        // Feed the filter with every new sample, not only when the change detection reads the value
+        if (takeNewSample()) {
+            currentAdcValueReady = false;
+            readValue();
+        }
+    }
+#ifdef HAL_DMA_MODULE_ENABLED
+    // The interrupt has disabled the watchdog
+    if (watchdogTriggered) {
+        watchdogTriggered = false;
+        watchdogArmPending = true;
+    }
+#endif
     Pin::loop();
     changeHandler();
+#ifdef HAL_DMA_MODULE_ENABLED
+    if (watchdogEnabled) {
+        if (watchdogArmPending) {
+            watchdogArmPending = false;
+            armWatchdog();
+        }
+#ifdef LIBSMART_STM32GPIO_ENABLE_TIMER_WHEEL
+        idleFor(hasChanged() || hasLoopCallback() ? 0 : NO_DEADLINE);
+#else
+        loopIdle = !hasChanged() && !hasLoopCallback();
+#endif
+        // An interrupt after the check above must not be lost
+        if (watchdogTriggered) wakeUp();
+        return;
+    }
+#endif
+#ifdef LIBSMART_STM32GPIO_ENABLE_TIMER_WHEEL
+    idleFor(hasLoopCallback() ? 0 : millisUntilNextDeadline());
+#endif
 //    lastLoopAdcValue = readValue();
 }
 
+bool PinAnalogIn::takeNewSample() {
+    // The scan group and the blocking conversion provide a new sample on every read
+    if (asyncConverter == nullptr) return true;
+    asyncConverter->poll();
+    // The converter stores a sample of the channel only once per round robin
+    const uint32_t sequence = asyncConverter->getSampleSequence(asyncIndex);
+    if (sequence == asyncSampleSequence) return false;
+    asyncSampleSequence = sequence;
+    return true;
+}
+
+uint32_t PinAnalogIn::millisUntilNextDeadline() {
+    const uint32_t deadlineMs = Pin::millisUntilNextDeadline();
+#ifdef HAL_DMA_MODULE_ENABLED
+    if (watchdogEnabled) return watchdogTriggered ? 0 : deadlineMs;
+#endif
+    const uint32_t sampleMs = millisRemaining(millis() - lastSampleMs, sampleIntervalMs);
+    return sampleMs < deadlineMs ? sampleMs : deadlineMs;
+}
+
 #endif
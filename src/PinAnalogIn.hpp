@@ -12,8 +12,35 @@
 #ifdef HAL_ADC_MODULE_ENABLED
 
 #include "Pin.hpp"
+#include "AdcScanGroup.hpp"
+#include "AdcAsyncConverter.hpp"
+#include "AnalogFilter.hpp"
+#include "AnalogTransform.hpp"
 #include "adc.h"
 
+/**
+ * Default deadband in ADC counts: the value has to move more than this from the last reported value,
+ * before the onChange callback is triggered. 30 counts are about 0.15 mA on a 4..20 mA input.
+ */
+#ifndef LIBSMART_STM32GPIO_ANALOG_DEADBAND
+#define LIBSMART_STM32GPIO_ANALOG_DEADBAND 30
+#endif
+
+/**
+ * Default hysteresis in ADC counts: the additional distance, that is required to report a change in the
+ * opposite direction of the last reported change.
+ */
+#ifndef LIBSMART_STM32GPIO_ANALOG_HYSTERESIS
+#define LIBSMART_STM32GPIO_ANALOG_HYSTERESIS 0
+#endif
+
+/**
+ * Default interval in milliseconds between two evaluations of an analog input. 0 evaluates the pin on every loop.
+ */
+#ifndef LIBSMART_STM32GPIO_ANALOG_SAMPLE_INTERVAL_MS
+#define LIBSMART_STM32GPIO_ANALOG_SAMPLE_INTERVAL_MS 0
+#endif
+
 namespace Stm32Gpio {
     class PinAnalogIn : public Pin {
     public:
@@ -31,9 +58,135 @@ namespace Stm32Gpio {
             : Pin(pinName, nullptr, 0, pinModeType::ANALOG_IN), hadc(hadc), ADC_Channel(ADC_Channel) {
         };
 
+#ifdef HAL_DMA_MODULE_ENABLED
+        /**
+         * @brief Create an analog input, that is converted by a scan group.
+         *
+         * The channel is added to the regular sequence of the group, and the group is started by setup().
+         * readValue() then returns the latest sample of the group without touching the ADC.
+         *
+         * If the sequence of the group is full, the channel is rejected and the pin is not converted at all,
+         * see isChannelRejected(). The group owns the ADC, so the pin must not fall back to conversions of its
+         * own, which would reconfigure and stop the running scan.
+         *
+         * @param pinName The name of the pin.
+         * @param scanGroup The scan group of the ADC.
+         * @param ADC_Channel The ADC channel, e.g. ADC_CHANNEL_8.
+         */
+        PinAnalogIn(const char *pinName, AdcScanGroup &scanGroup, uint32_t ADC_Channel)
+            : Pin(pinName, nullptr, 0, pinModeType::ANALOG_IN), hadc(scanGroup.getAdc()), ADC_Channel(ADC_Channel) {
+            const uint8_t index = scanGroup.addChannel(ADC_Channel);
+            if (index >= AdcScanGroup::maxChannels) {
+                channelRejected = true;
+                return;
+            }
+            this->scanGroup = &scanGroup;
+            scanIndex = index;
+        };
+
+        /**
+         * @brief Start the scan group, if the pin belongs to one.
+         */
+        void setup() override;
+
+        /**
+         * @brief Switch the pin to analog watchdog mode.
+         *
+         * The analog watchdog of the ADC is armed with the band of the change detection (see setDeadband() and
+         * setHysteresis()) around the last reported value. As long as the value stays in this band, the pin
+         * reports itself idle to PinManager and loop() is not called. When the value leaves the band, the
+         * watchdog interrupt wakes up the pin, which reports the change and arms the watchdog around the new
+         * value. The watchdog compares the unfiltered samples. If the filter of the pin adds bits, e.g. an
+         * OversampleFilter, the band is scaled down to the range of the ADC.
+         *
+         * The pin has to belong to a running scan group, see AdcScanGroup.
+         *
+         * @return true on success, false if the pin does not belong to a scan group, the output scale of its
+         * filter is not known (see FilterExtraBits) or the watchdog of the ADC is used by another pin.
+         */
+        bool enableWatchdog();
+
+        /**
+         * @brief Switch the pin back to evaluating every loop.
+         */
+        void disableWatchdog();
+
+        /**
+         * @brief Check if the pin is in analog watchdog mode.
+         */
+        bool isWatchdogEnabled() const { return watchdogEnabled; }
+
+        /**
+         * @brief Wake up the pin after the value has left the watchdog band.
+         *
+         * This method is called by AdcScanGroup in interrupt context and should not be called directly.
+         */
+        void handleWatchdog() {
+            watchdogTriggered = true;
+            wakeUp();
+        }
+#endif
+
+        /**
+         * @brief Create an analog input, that is converted by an asynchronous converter.
+         *
+         * The channel is added to the round robin of the converter. loop() advances the converter, and
+         * readValue() returns the last completed sample without waiting for the ADC.
+         *
+         * If the converter is full, the channel is rejected and the pin is not converted at all, see
+         * isChannelRejected(). A conversion of its own would reconfigure the ADC and stop the conversion of the
+         * round robin, that is in flight.
+         *
+         * @param pinName The name of the pin.
+         * @param converter The asynchronous converter of the ADC.
+         * @param ADC_Channel The ADC channel, e.g. ADC_CHANNEL_8.
+         */
+        PinAnalogIn(const char *pinName, AdcAsyncConverter &converter, uint32_t ADC_Channel)
+            : Pin(pinName, nullptr, 0, pinModeType::ANALOG_IN), hadc(converter.getAdc()), ADC_Channel(ADC_Channel) {
+            const uint8_t index = converter.addChannel(ADC_Channel);
+            if (index >= AdcAsyncConverter::maxChannels) {
+                channelRejected = true;
+                return;
+            }
+            asyncConverter = &converter;
+            asyncIndex = index;
+        };
 
         void loop() override;
 
+        /**
+         * @brief Check if the scan group or converter, that was passed to the constructor, was full.
+         *
+         * A rejected pin is not converted, its raw value is always 0. Check this after constructing the pins,
+         * and increase LIBSMART_STM32GPIO_ADC_SCAN_MAX_CHANNELS or LIBSMART_STM32GPIO_ADC_ASYNC_MAX_CHANNELS, if
+         * a pin was rejected.
+         *
+         * @return true if the channel was rejected, false otherwise.
+         */
+        bool isChannelRejected() const { return channelRejected; }
+
+        /**
+         * @brief Set the interval between two evaluations of the pin.
+         *
+         * loop() takes a new sample and runs the change detection once per interval only. In between,
+         * readValue() returns the last sample. An AdcAsyncConverter is advanced once per interval, too, and
+         * its sample is passed to the filter only, if the converter has stored a new one for the channel.
+         * The interval is ignored in analog watchdog mode.
+         *
+         * @param intervalMs The interval in milliseconds. 0 evaluates the pin on every loop.
+         */
+        void setSampleInterval(const uint32_t intervalMs) {
+            sampleIntervalMs = intervalMs;
+            wakeUp();
+        }
+
+        /**
+         * @brief Get the number of milliseconds until the next sample is taken.
+         *
+         * @see Pin::millisUntilNextDeadline()
+         */
+        uint32_t millisUntilNextDeadline() override;
+
         uint32_t readValueFromAdc() {
             uint32_t adc_value;
             ADC_ChannelConfTypeDef sConfig;
@@ -67,36 +220,189 @@ namespace Stm32Gpio {
             return adc_value;
         }
 
+        /**
+         * @brief Read the current sample, without filtering.
+         *
+         * @return The ADC value from the async converter, the scan group or a blocking conversion, 0 if the
+         * channel was rejected by its scan group or converter.
+         */
+        uint32_t readRawValue() {
+            if (asyncConverter != nullptr) return asyncConverter->read(asyncIndex);
+#ifdef HAL_DMA_MODULE_ENABLED
+            if (scanGroup != nullptr) return scanGroup->read(scanIndex);
+#endif
+            // The ADC is owned by the scan group or converter, that rejected the channel
+            if (channelRejected) return 0;
+            return readValueFromAdc();
+        }
+
+        /**
+         * @brief Read the value of the pin.
+         *
+         * The sample is taken and passed through filterSample() once per sample interval by loop() and cached
+         * until the next sample is due. A sample of an AdcAsyncConverter is passed through the filter once
+         * per conversion, however often the interval elapses in between.
+         *
+         * @return The filtered ADC value.
+         */
         uint32_t readValue() {
-            return currentAdcValueReady ? currentAdcValue : (currentAdcValue = readValueFromAdc());
+            if (!currentAdcValueReady) {
+                currentAdcValue = filterSample(readRawValue());
+                currentAdcValueReady = true;
+            }
+            return currentAdcValue;
+        }
+
+        /**
+         * @brief Read the value together with its age.
+         *
+         * @param ageMs Receives the number of milliseconds since the sample was taken. This is 0, unless the pin
+         * is converted by an AdcAsyncConverter.
+         * @return The ADC value.
+         */
+        uint32_t readValue(uint32_t &ageMs) {
+            ageMs = millisSinceLastSample();
+            return readValue();
         }
 
+        /**
+         * @brief Get the number of milliseconds since the sample, that is returned by readValue(), was taken.
+         *
+         * @return The age of the sample in milliseconds.
+         */
+        uint32_t millisSinceLastSample() const {
+            return asyncConverter != nullptr ? asyncConverter->millisSinceSample(asyncIndex) : 0;
+        }
+
+        /**
+         * @brief The default transform: 4..20 mA on a 165 Ohm shunt with a 12 bit ADC to percent.
+         *
+         * 0    |    0V |  0mA | -27%
+         * 819  | 0.66V |  4mA |   0%
+         * 4096 |  3.3V | 20mA | 110%
+         *
+         * R = U/I = 3.3V/20mA = 165Ω
+         * U(0) = R*I(0) = 165Ω*4mA = 0.66V
+         * v(0) = 20mA*4096/I = 20mA*4096/4mA = 819.2
+         * p = 110*(v-819)/(4096-819)
+         */
+        static constexpr LinearTransform currentLoopPercent{819, 0, 4096, 110};
+
         static int8_t calculateValue(uint32_t val) {
-            /*
-             * 0    |    0V |  0mA | -27%
-             * 819  | 0.66V |  4mA |   0%
-             * 4096 |  3.3V | 20mA | 110%
-             *
-             * R = U/I = 3.3V/20mA = 165Ω
-             * U(0) = R*I(0) = 165Ω*4mA = 0.66V
-             * v(0) = 20mA*4096/I = 20mA*4096/4mA = 819.2
-             * p = 110*(v-819)/(4096-819) =
-             */
-            return (int8_t) ((110L * ((int64_t) val - 819L)) / (4096L - 819L));
+            return (int8_t) currentLoopPercent.transform(val);
         }
 
+        /**
+         * @brief Set the transform, that converts the value of this pin into user units.
+         *
+         * The transform is usually a constexpr object, e.g. a LinearTransform or a PiecewiseLinearTransform.
+         * It has to stay valid as long as the pin uses it.
+         *
+         * @param newTransform The transform.
+         */
+        void setTransform(const AnalogTransform &newTransform) { transform = &newTransform; }
+
+        /**
+         * @brief Read the value and convert it with the transform of the pin.
+         *
+         * @return The value in user units.
+         */
+        int32_t readTransformedValue() {
+            return transform->transform(readValue());
+        }
+
+        /**
+         * @brief Read the value and convert it with the transform of the pin, limited to the range of int8_t.
+         *
+         * This is the interface of the default percent transform. Values of other transforms, that do not fit,
+         * are clamped to -128..127, use readTransformedValue() to get them in full.
+         *
+         * @return The value in user units, clamped to -128..127.
+         */
         int8_t readCalculatedValue() {
-            return calculateValue(readValue());
+            const int32_t value = readTransformedValue();
+            return static_cast<int8_t>(value < INT8_MIN ? INT8_MIN : (value > INT8_MAX ? INT8_MAX : value));
+        }
+
+        /**
+         * @brief Set the deadband of the change detection.
+         *
+         * The change detection works on the raw value. A change is reported, when the value leaves the band
+         * of +/- deadbandCounts around the last reported value.
+         *
+         * @param deadbandCounts The deadband in ADC counts.
+         */
+        void setDeadband(const uint16_t deadbandCounts) {
+            deadband = deadbandCounts;
+            updateChangeThresholds();
+        }
+
+        /**
+         * @brief Set the hysteresis of the change detection.
+         *
+         * A change in the opposite direction of the last reported change has to exceed the deadband by
+         * hysteresisCounts. This suppresses chattering of a value, that sits at a threshold.
+         *
+         * @param hysteresisCounts The hysteresis in ADC counts.
+         */
+        void setHysteresis(const uint16_t hysteresisCounts) {
+            hysteresis = hysteresisCounts;
+            updateChangeThresholds();
         }
 
     protected:
+        /**
+         * @brief Filter a new sample.
+         *
+         * This method is called by loop() with every new sample. Sub classes override it to apply
+         * a filter, see PinAnalogInFiltered.
+         *
+         * @param sample The raw ADC value.
+         * @return The filtered value.
+         */
+        virtual uint32_t filterSample(const uint32_t sample) { return sample; }
+
+        /**
+         * @brief Get the number of bits, that filterSample() adds to the raw value.
+         *
+         * @return The number of bits, unknownFilterScale if it is not known.
+         */
+        virtual uint8_t getFilterExtraBits() const { return 0; }
+
         bool hasChanged() override {
-            return (Pin::hasChanged() || (calculateValue(lastChangeHandlerAdcValue) != readCalculatedValue()));
+            const uint32_t value = readValue();
+            return Pin::hasChanged() || (value < changeLow) || (value > changeHigh);
         }
 
         void resetChange() override {
             Pin::resetChange();
-            lastChangeHandlerAdcValue = readValue();
+            const uint32_t value = readValue();
+            if (value != lastChangeHandlerAdcValue) lastChangeRising = value > lastChangeHandlerAdcValue;
+            lastChangeHandlerAdcValue = value;
+            updateChangeThresholds();
+        }
+
+        void describeChange(PinEvent &event) override {
+            Pin::describeChange(event);
+            const uint32_t value = readValue();
+            event.value = static_cast<int32_t>(value);
+            if (value != lastChangeHandlerAdcValue) {
+                event.edge = value > lastChangeHandlerAdcValue ? pinEdgeType::RISING : pinEdgeType::FALLING;
+            }
+            event.timestampMs -= millisSinceLastSample();
+        }
+
+        /**
+         * @brief Precompute the band around the last reported value, so hasChanged() needs two compares only.
+         */
+        void updateChangeThresholds() {
+            const uint32_t below = deadband + (lastChangeRising ? hysteresis : 0);
+            const uint32_t above = deadband + (lastChangeRising ? 0 : hysteresis);
+            changeLow = lastChangeHandlerAdcValue > below ? lastChangeHandlerAdcValue - below : 0;
+            changeHigh = lastChangeHandlerAdcValue + above;
+#ifdef HAL_DMA_MODULE_ENABLED
+            watchdogArmPending = true;
+#endif
         }
 
     private:
@@ -104,9 +410,61 @@ namespace Stm32Gpio {
         bool currentAdcValueReady = false;
         //    uint32_t lastLoopAdcValue = 0;
         uint32_t lastChangeHandlerAdcValue = 0;
+        const AnalogTransform *transform = &currentLoopPercent;
+        uint32_t changeLow = 0;
+        uint32_t changeHigh = 0;
+        uint16_t deadband = LIBSMART_STM32GPIO_ANALOG_DEADBAND;
+        uint16_t hysteresis = LIBSMART_STM32GPIO_ANALOG_HYSTERESIS;
+        bool lastChangeRising = true;
 
         ADC_HandleTypeDef *hadc;
         uint32_t ADC_Channel;
+
+        AdcAsyncConverter *asyncConverter = nullptr;
+        uint8_t asyncIndex = 0;
+
+        /**
+         * @brief Sequence number of the last sample of the async converter, that was passed to the filter.
+         */
+        uint32_t asyncSampleSequence = 0;
+
+        bool channelRejected = false;
+
+        uint32_t sampleIntervalMs = LIBSMART_STM32GPIO_ANALOG_SAMPLE_INTERVAL_MS;
+
+        /**
+         * @brief Timestamp in milliseconds of the last evaluation.
+         */
+        uint32_t lastSampleMs = 0;
+
+        /**
+         * @brief Advance the async converter and check, if it has stored a new sample of the pin.
+         *
+         * @return true if the filter has to be fed with the current sample, false otherwise.
+         */
+        bool takeNewSample();
+
+#ifdef HAL_DMA_MODULE_ENABLED
+        /**
+         * @brief Arm the watchdog with the current band of the change detection.
+         */
+        bool armWatchdog();
+
+        AdcScanGroup *scanGroup = nullptr;
+        uint8_t scanIndex = 0;
+        bool watchdogEnabled = false;
+
+        /**
+         * @brief Set by the watchdog interrupt, cleared by loop().
+         */
+        volatile bool watchdogTriggered = false;
+
+        /**
+         * @brief Set, when the band of the change detection has moved or the interrupt has disabled the
+         * watchdog, so loop() has to arm it again.
+         */
+        bool watchdogArmPending = false;
+#endif
     };
 }
 
@@ -0,0 +1,49 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32GPIO_PINANALOGINFILTERED_H
+#define LIBSMART_STM32GPIO_PINANALOGINFILTERED_H
+
+#include "PinAnalogIn.hpp"
+
+#ifdef HAL_ADC_MODULE_ENABLED
+
+#include "AnalogFilter.hpp"
+
+namespace Stm32Gpio {
+    /**
+     * @class PinAnalogInFiltered
+     * @brief An analog input, whose samples pass a fixed point filter, before they are evaluated.
+     *
+     * loop() feeds the filter with a new sample once per sample interval (every loop() by default, see
+     * setSampleInterval()), even while the change detection is deferred. readValue(), calculateValue() and the
+     * change detection see the filtered value only, so noise does not trigger onChange callbacks.
+     *
+     * Example: PinAnalogInFiltered<MovingAverageFilter<8>> pin("AI1", &hadc1, ADC_CHANNEL_8);
+     *
+     * @tparam Filter The filter, e.g. ExponentialFilter, MovingAverageFilter, OversampleFilter or FilterChain.
+     */
+    template<typename Filter>
+    class PinAnalogInFiltered : public PinAnalogIn {
+    public:
+        using PinAnalogIn::PinAnalogIn;
+
+        /**
+         * @brief Get the filter, e.g. to inspect its state.
+         */
+        Filter &getFilter() { return filter; }
+
+    protected:
+        uint32_t filterSample(const uint32_t sample) override { return filter.filter(sample); }
+
+        uint8_t getFilterExtraBits() const override { return FilterExtraBits<Filter>::value; }
+
+    private:
+        Filter filter;
+    };
+}
+
+#endif
+#endif //LIBSMART_STM32GPIO_PINANALOGINFILTERED_H
@@ -10,19 +10,48 @@ using namespace Stm32Gpio;
 void PinDigital::loop() {
     Pin::loop();
     updatePinState();
+    // The pin is polled, so it has work on every loop
+    wakeUp();
 }
 
 void PinDigital::updatePinState() {
-    if (isOn() && !lastLoopPinState) {
+    const bool on = isOn();
+    if (on != lastLoopPinState) recordChange(on, TimeBase::capture());
+    lastLoopPinState = on;
+
+    changeHandler();
+}
+
+void PinDigital::applyPinState(const bool on, const uint32_t captured) {
+    if (on != lastLoopPinState) recordChange(on, captured);
+    lastLoopPinState = on;
+
+    changeHandler();
+}
+
+void PinDigital::describeChange(PinEvent &event) {
+    const bool on = lastLoopPinState;
+    event.on = on;
+    event.value = on ? 1 : 0;
+    if (on != lastChangeHandlerPinState) event.edge = on ? pinEdgeType::RISING : pinEdgeType::FALLING;
+    event.timestampMs = on ? lastChangeToOn : lastChangeToOff;
+    event.sincePreviousMs = on ? lastChangeToOn - lastChangeToOff : lastChangeToOff - lastChangeToOn;
+}
+
+void PinDigital::recordChange(const bool on, const uint32_t captured) {
+    if (on) {
         // Pin is now on, was off before
-        lastChangeToOn = millis();
-    } else if (isOff() && lastLoopPinState) {
+        lastChangeToOn = TimeBase::toMillis(captured);
+#ifdef LIBSMART_STM32GPIO_ENABLE_DWT_TIMEBASE
+        lastChangeToOnCycles = DwtTimeBase::extend(captured);
+#endif
+    } else {
         // Pin is now off, was on before
-        lastChangeToOff = millis();
+        lastChangeToOff = TimeBase::toMillis(captured);
+#ifdef LIBSMART_STM32GPIO_ENABLE_DWT_TIMEBASE
+        lastChangeToOffCycles = DwtTimeBase::extend(captured);
+#endif
     }
-    lastLoopPinState = isOn();
-
-    changeHandler();
 }
 
 void PinDigital::setInverted(bool newValue /* = true */) {
@@ -34,20 +63,37 @@ void PinDigital::setInverted(bool newValue /* = true */) {
     lastLoopPinState = !lastLoopPinState;
     lastChangeHandlerPinState = !lastChangeHandlerPinState;
     inverted = newValue;
+    updateRegisterMasks();
+}
+
+void PinDigital::updateRegisterMasks() {
+    const uint32_t set = GPIO_Pin;
+    const uint32_t reset = static_cast<uint32_t>(GPIO_Pin) << 16u;
+    bsrrOn = inverted ? reset : set;
+    bsrrOff = inverted ? set : reset;
+    idrOn = inverted ? 0 : GPIO_Pin;
 }
 
 bool PinDigital::isOn() {
 #if __EXCEPTIONS
     setupDone ? (void) 0 : throw "call setup() first";
 #endif
+#ifdef LIBSMART_STM32GPIO_ENABLE_REGISTER_ACCESS
+    return (GPIOx->IDR & GPIO_Pin) == idrOn;
+#else
     return HAL_GPIO_ReadPin(GPIOx, GPIO_Pin) == (inverted ? GPIO_PIN_RESET : GPIO_PIN_SET);
+#endif
 }
 
 bool PinDigital::isOff() {
 #if __EXCEPTIONS
     setupDone ? (void) 0 : throw "call setup() first";
 #endif
+#ifdef LIBSMART_STM32GPIO_ENABLE_REGISTER_ACCESS
+    return (GPIOx->IDR & GPIO_Pin) != idrOn;
+#else
     return HAL_GPIO_ReadPin(GPIOx, GPIO_Pin) == (inverted ? GPIO_PIN_SET : GPIO_PIN_RESET);
+#endif
 }
 
 uint32_t PinDigital::millisSinceLastOn() {
@@ -62,13 +108,29 @@ uint32_t PinDigital::millisSinceLastChange() {
     return isOn() ? millisSinceLastOn() : millisSinceLastOff();
 }
 
+#ifdef LIBSMART_STM32GPIO_ENABLE_DWT_TIMEBASE
+
+uint64_t PinDigital::cyclesSinceLastOn() {
+    return DwtTimeBase::now() - lastChangeToOnCycles;
+}
+
+uint64_t PinDigital::cyclesSinceLastOff() {
+    return DwtTimeBase::now() - lastChangeToOffCycles;
+}
+
+uint64_t PinDigital::cyclesSinceLastChange() {
+    return lastLoopPinState ? cyclesSinceLastOn() : cyclesSinceLastOff();
+}
+
+#endif
+
 bool PinDigital::hasChanged() {
-    return (Pin::hasChanged() || (lastChangeHandlerPinState != isOn()));
+    return (Pin::hasChanged() || (lastChangeHandlerPinState != lastLoopPinState));
 }
 
 void PinDigital::resetChange() {
     Pin::resetChange();
-    lastChangeHandlerPinState = isOn();
+    lastChangeHandlerPinState = lastLoopPinState;
 }
 
 
@@ -8,27 +8,32 @@
 #define LIBSMART_STM32GPIO_PINDIGITAL_H
 
 #include <Pin.hpp>
+#include "TimeBase.hpp"
 
 namespace Stm32Gpio {
     class PinDigital : public Pin {
     protected:
         PinDigital(GPIO_TypeDef *GPIOx, const uint16_t gpioPin, const pinModeType pinMode)
             : Pin(GPIOx, gpioPin, pinMode) {
+            updateRegisterMasks();
         }
 
         PinDigital(GPIO_TypeDef *GPIOx, const uint16_t gpioPin, const pinModeType pinMode, const bool isInverted)
             : Pin(GPIOx, gpioPin, pinMode),
               inverted(isInverted) {
+            updateRegisterMasks();
         }
 
         PinDigital(const char *pinName, GPIO_TypeDef *GPIOx, const uint16_t gpioPin, const pinModeType pinMode)
             : Pin(pinName, GPIOx, gpioPin, pinMode) {
+            updateRegisterMasks();
         }
 
         PinDigital(const char *pinName, GPIO_TypeDef *GPIOx, const uint16_t gpioPin, const pinModeType pinMode,
                    const bool isInverted)
             : Pin(pinName, GPIOx, gpioPin, pinMode),
               inverted(isInverted) {
+            updateRegisterMasks();
         }
 
     public:
@@ -48,7 +53,7 @@ namespace Stm32Gpio {
          *
          * @param newValue The new inverted state of the pin. The default value is true.
          */
-        void setInverted(bool newValue = true);
+        virtual void setInverted(bool newValue = true);
 
         /**
          * @brief Check if the pin is currently on.
@@ -72,6 +77,20 @@ namespace Stm32Gpio {
          */
         virtual bool isOff();
 
+        /**
+         * @brief Get the BSRR word, that drives the pin to the "on" state, taking the inverted flag into account.
+         *
+         * @return The BSRR word.
+         */
+        uint32_t getBsrrOn() const { return bsrrOn; }
+
+        /**
+         * @brief Get the BSRR word, that drives the pin to the "off" state, taking the inverted flag into account.
+         *
+         * @return The BSRR word.
+         */
+        uint32_t getBsrrOff() const { return bsrrOff; }
+
         /**
          * @brief Get the number of milliseconds since the last time the PinDigital was turned on.
          *
@@ -108,24 +127,96 @@ namespace Stm32Gpio {
          */
         virtual uint32_t millisSinceLastChange();
 
+        /**
+         * @brief Get the number of milliseconds, until the pending change may be reported.
+         *
+         * @see Pin::millisUntilNextDeadline()
+         */
+        uint32_t millisUntilNextDeadline() override {
+            return isStateChangePending() ? millisUntilOnChangeCallback(true) : Pin::millisUntilNextDeadline();
+        }
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_DWT_TIMEBASE
+        /**
+         * @brief Get the number of CPU cycles since the last time the pin was turned on.
+         *
+         * @return The number of cycles since the last change to "on".
+         */
+        virtual uint64_t cyclesSinceLastOn();
+
+        /**
+         * @brief Get the number of CPU cycles since the last time the pin was turned off.
+         *
+         * @return The number of cycles since the last change to "off".
+         */
+        virtual uint64_t cyclesSinceLastOff();
+
+        /**
+         * @brief Get the number of CPU cycles since the most recent state change of the pin.
+         *
+         * @return The number of cycles since the last change.
+         */
+        virtual uint64_t cyclesSinceLastChange();
+
+        /**
+         * @brief Get the number of microseconds since the last time the pin was turned on.
+         *
+         * @return The number of microseconds since the last change to "on".
+         */
+        uint64_t microsSinceLastOn() { return DwtTimeBase::cyclesToMicros(cyclesSinceLastOn()); }
+
+        /**
+         * @brief Get the number of microseconds since the last time the pin was turned off.
+         *
+         * @return The number of microseconds since the last change to "off".
+         */
+        uint64_t microsSinceLastOff() { return DwtTimeBase::cyclesToMicros(cyclesSinceLastOff()); }
+
+        /**
+         * @brief Get the number of microseconds since the most recent state change of the pin.
+         *
+         * @return The number of microseconds since the last change.
+         */
+        uint64_t microsSinceLastChange() { return DwtTimeBase::cyclesToMicros(cyclesSinceLastChange()); }
+#endif
+
     protected:
         /**
          * @brief Update the state of the pin.
          *
-         * This method is responsible for updating the state of the pin. It checks if the pin is on or off and stores the last change
-         * to on and off timestamps. It also calls the `changeHandler()` method.
+         * This method is responsible for updating the state of the pin. It reads the pin once, stores the last change
+         * to on and off timestamps and keeps the state for hasChanged() and resetChange(). It also calls the
+         * `changeHandler()` method.
          *
          * @note This method is called internally by the `loop()` method and should not be called directly.
          */
         virtual void updatePinState();
 
+        /**
+         * @brief Apply a pin state, that was captured elsewhere (e.g. in an interrupt).
+         *
+         * This method does the same as updatePinState(), but takes the state and the timestamp of the
+         * change from the caller instead of reading the pin.
+         *
+         * @param on The captured pin state.
+         * @param captured The time, when the state was captured, as returned by TimeBase::capture().
+         */
+        void applyPinState(bool on, uint32_t captured);
+
+        /**
+         * @brief Get the pin state, as read by the last updatePinState() or applyPinState().
+         *
+         * @return True if the pin was on, false otherwise.
+         */
+        bool getPinState() const { return lastLoopPinState; }
+
         /**
          * @brief Determines whether the pin state has changed or not.
          *
          * This method returns a boolean value indicating whether the pin state has changed or not.
          * It first calls the hasChanged() method of the parent class, Pin, and checks if the pin state
-         * has changed. Then, it compares the current pin state with the previous pin state stored in
-         * the lastChangeHandlerPinState variable. If there is any change, it returns true; otherwise,
+         * has changed. Then, it compares the pin state read by the last updatePinState() with the previous
+         * pin state stored in the lastChangeHandlerPinState variable. If there is any change, it returns true; otherwise,
          * it returns false.
          *
          * @return Boolean value indicating whether the pin state has changed or not.
@@ -137,12 +228,40 @@ namespace Stm32Gpio {
          *
          * This method is responsible for resetting the change handler's last pin state in the PinDigital class.
          * It calls the resetChange() method of the parent class Pin, and then updates the lastChangeHandlerPinState
-         * attribute with the current state of the pin (on/off).
+         * attribute with the pin state read by the last updatePinState() (on/off).
          *
          * This method should be called whenever you want to reset the change handler's last pin state.
          */
         void resetChange() override;
 
+        /**
+         * @brief Describe the change with the latched pin state and the timestamps of the last changes.
+         *
+         * @param event The event to fill in.
+         */
+        void describeChange(PinEvent &event) override;
+
+        /**
+         * @brief Check if the change handler still has work to do.
+         *
+         * A change is pending, if a forced onChange callback is outstanding or if the pin state, read by the last
+         * updatePinState(), has not been reported by the onChange callback yet (e.g. because it is deferred).
+         *
+         * @return true if changeHandler() has to be called again, false otherwise.
+         */
+        bool isChangePending() const {
+            return isForcedOnChangeCallbackPending() || isStateChangePending();
+        }
+
+        /**
+         * @brief Check if the pin state, read by the last updatePinState(), has not been reported yet.
+         *
+         * @return true if the state differs from the state, that was reported by the last onChange callback.
+         */
+        bool isStateChangePending() const {
+            return lastChangeHandlerPinState != lastLoopPinState;
+        }
+
         /**
          * @brief Indicates whether the pin is inverted.
          *
@@ -153,7 +272,46 @@ namespace Stm32Gpio {
          */
         bool inverted = false;
 
+        /**
+         * @brief Recalculate the precomputed register masks.
+         *
+         * This method folds the `inverted` flag into the BSRR words and the IDR compare value,
+         * so that reading and writing the pin does not need to evaluate the polarity again.
+         * It has to be called whenever `GPIO_Pin` or `inverted` changes.
+         */
+        void updateRegisterMasks();
+
+        /**
+         * @brief BSRR word, that drives the pin to the "on" state.
+         *
+         * The lower half sets the pin, the upper half resets the pin. Depending on `inverted`,
+         * the "on" state is a set or a reset of the pin.
+         */
+        uint32_t bsrrOn = 0;
+
+        /**
+         * @brief BSRR word, that drives the pin to the "off" state.
+         *
+         * @see bsrrOn
+         */
+        uint32_t bsrrOff = 0;
+
+        /**
+         * @brief Value of `IDR & GPIO_Pin`, that represents the "on" state.
+         *
+         * This is `GPIO_Pin` for a normal pin and 0 for an inverted pin.
+         */
+        uint16_t idrOn = 0;
+
     private:
+        /**
+         * @brief Store the timestamps of a state change.
+         *
+         * @param on The new pin state.
+         * @param captured The time of the change, as returned by TimeBase::capture().
+         */
+        void recordChange(bool on, uint32_t captured);
+
         /**
          * @brief Stores the previous pin state during the last loop iteration.
          *
@@ -190,6 +348,18 @@ namespace Stm32Gpio {
          * This variable can be useful for various time-related calculations.
          */
         uint32_t lastChangeToOff = 0;
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_DWT_TIMEBASE
+        /**
+         * @brief The 64-bit cycle count of the last change to the "on" state.
+         */
+        uint64_t lastChangeToOnCycles = 0;
+
+        /**
+         * @brief The 64-bit cycle count of the last change to the "off" state.
+         */
+        uint64_t lastChangeToOffCycles = 0;
+#endif
     };
 }
 
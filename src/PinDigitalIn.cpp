@@ -4,5 +4,191 @@
  */
 
 #include "PinDigitalIn.hpp"
+#include "GpioPort.hpp"
 
 using namespace Stm32Gpio;
+
+#if defined(LIBSMART_STM32GPIO_ENABLE_PORT_SNAPSHOT) || defined(LIBSMART_STM32GPIO_ENABLE_EXTI) \
+    || defined(LIBSMART_STM32GPIO_ENABLE_DEBOUNCE)
+
+bool PinDigitalIn::isOn() {
+#if __EXCEPTIONS
+    setupDone ? (void) 0 : throw "call setup() first";
+#endif
+#if defined(LIBSMART_STM32GPIO_ENABLE_EXTI) && defined(HAL_EXTI_MODULE_ENABLED)
+    if (interruptMode) return getPinState();
+#endif
+#ifdef LIBSMART_STM32GPIO_ENABLE_DEBOUNCE
+    if (debounced) return (PortDebounce::read(GPIOx) & GPIO_Pin) == idrOn;
+#endif
+#ifdef LIBSMART_STM32GPIO_ENABLE_PORT_SNAPSHOT
+    return (PortSnapshot::read(GPIOx) & GPIO_Pin) == idrOn;
+#else
+    return PinDigital::isOn();
+#endif
+}
+
+bool PinDigitalIn::isOff() {
+    return !isOn();
+}
+
+#endif
+
+uint32_t PinDigitalIn::millisUntilNextDeadline() {
+#if defined(LIBSMART_STM32GPIO_ENABLE_EXTI) && defined(HAL_EXTI_MODULE_ENABLED)
+    if (interruptMode) {
+        if (isEdgePending()) return 0;
+        return PinDigital::millisUntilNextDeadline();
+    }
+#endif
+    return 0;
+}
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_DEBOUNCE
+
+void PinDigitalIn::setDebounce(const bool enable) {
+    if (enable) PortDebounce::use(GPIOx);
+    debounced = enable;
+}
+
+#endif
+
+#if defined(LIBSMART_STM32GPIO_ENABLE_EXTI) && defined(HAL_EXTI_MODULE_ENABLED)
+
+void PinDigitalIn::loop() {
+    if (!interruptMode) {
+        PinDigital::loop();
+        return;
+    }
+
+    Pin::loop();
+
+    if (!processLatchedEdges() && isChangePending()) {
+        changeHandler();
+    }
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_TIMER_WHEEL
+    idleFor(hasLoopCallback() ? 0 : millisUntilNextDeadline());
+#else
+    loopIdle = !isEdgePending() && !isChangePending() && !hasLoopCallback();
+#endif
+
+    // An edge, that was latched after the checks above, must not be lost
+    if (isEdgePending()) wakeUp();
+}
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_EDGE_EVENT_RING
+
+bool PinDigitalIn::processLatchedEdges() {
+    // Edges are delivered by ExtiDispatcher::drainEvents()
+    return false;
+}
+
+void PinDigitalIn::handleEdgeEvent(const EdgeEvent &event) {
+    if (!interruptMode) return;
+    applyPinState(event.level != 0, event.timestamp);
+    wakeUp();
+}
+
+void PinDigitalIn::handleEventOverflow() {
+    if (!interruptMode) return;
+    applyPinState(PinDigital::isOn(), TimeBase::capture());
+    wakeUp();
+}
+
+#else
+
+bool PinDigitalIn::processLatchedEdges() {
+    if (edgeCount == edgeCountProcessed) return false;
+
+    uint32_t count;
+    bool on;
+    uint32_t captured;
+    do {
+        count = edgeCount;
+        on = edgeOn;
+        captured = edgeCaptured;
+    } while (count != edgeCount);
+
+    const uint32_t edges = count - edgeCountProcessed;
+    edgeCountProcessed = count;
+    if ((on == getPinState()) && (edges >= 2)) {
+        // A pulse shorter than one loop period, report both edges
+        applyPinState(!on, captured);
+    }
+    applyPinState(on, captured);
+    return true;
+}
+
+#endif
+
+bool PinDigitalIn::enableInterrupt() {
+    if (!setupDone) return false;
+    const uint8_t line = getExtiLine();
+    if (!ExtiDispatcher::attach(line, this)) return false;
+
+    static constexpr uint32_t extiLines[16] = {
+        EXTI_LINE_0, EXTI_LINE_1, EXTI_LINE_2, EXTI_LINE_3,
+        EXTI_LINE_4, EXTI_LINE_5, EXTI_LINE_6, EXTI_LINE_7,
+        EXTI_LINE_8, EXTI_LINE_9, EXTI_LINE_10, EXTI_LINE_11,
+        EXTI_LINE_12, EXTI_LINE_13, EXTI_LINE_14, EXTI_LINE_15,
+    };
+
+#ifdef __HAL_RCC_AFIO_CLK_ENABLE
+    __HAL_RCC_AFIO_CLK_ENABLE();
+#endif
+#ifdef __HAL_RCC_SYSCFG_CLK_ENABLE
+    __HAL_RCC_SYSCFG_CLK_ENABLE();
+#endif
+
+    EXTI_HandleTypeDef hexti = {};
+    EXTI_ConfigTypeDef extiConfig = {};
+    extiConfig.Line = extiLines[line];
+    extiConfig.Mode = EXTI_MODE_INTERRUPT;
+    extiConfig.Trigger = EXTI_TRIGGER_RISING_FALLING;
+    extiConfig.GPIOSel = GpioPort::index(GPIOx);
+
+#ifndef LIBSMART_STM32GPIO_ENABLE_EDGE_EVENT_RING
+    edgeCountProcessed = edgeCount;
+#endif
+    interruptMode = true;
+    wakeUp();
+
+    if (HAL_EXTI_SetConfigLine(&hexti, &extiConfig) != HAL_OK) {
+        disableInterrupt();
+        return false;
+    }
+    HAL_EXTI_ClearPending(&hexti, EXTI_TRIGGER_RISING_FALLING);
+
+    const IRQn_Type irqn = ExtiDispatcher::getIrqn(line);
+    HAL_NVIC_SetPriority(irqn, LIBSMART_STM32GPIO_EXTI_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(irqn);
+
+    // Edges from now on are latched by the interrupt, so the current state can be taken as start value
+    applyPinState(PinDigital::isOn(), TimeBase::capture());
+    return true;
+}
+
+void PinDigitalIn::disableInterrupt() {
+    const uint8_t line = getExtiLine();
+    EXTI->IMR &= ~(1u << line);
+    EXTI->RTSR &= ~(1u << line);
+    EXTI->FTSR &= ~(1u << line);
+    ExtiDispatcher::detach(line);
+    interruptMode = false;
+    wakeUp();
+}
+
+void PinDigitalIn::handleInterrupt() {
+    const bool on = (GPIOx->IDR & GPIO_Pin) == idrOn;
+#ifdef LIBSMART_STM32GPIO_ENABLE_EDGE_EVENT_RING
+    ExtiDispatcher::pushEvent({TimeBase::capture(), getExtiLine(), static_cast<uint8_t>(on)});
+#else
+    edgeOn = on;
+    edgeCaptured = TimeBase::capture();
+    edgeCount = edgeCount + 1;
+    wakeUp();
+#endif
+}
+
+#endif
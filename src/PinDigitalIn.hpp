@@ -8,6 +8,13 @@
 
 #include <PinDigital.hpp>
 
+#ifdef LIBSMART_STM32GPIO_ENABLE_PORT_SNAPSHOT
+#include "PortSnapshot.hpp"
+#endif
+
+#include "ExtiDispatcher.hpp"
+#include "PortDebounce.hpp"
+
 namespace Stm32Gpio {
     class PinDigitalIn : public PinDigital {
     public:
@@ -26,6 +33,175 @@ namespace Stm32Gpio {
         PinDigitalIn(const char *pinName, GPIO_TypeDef *GPIOx, const uint16_t GPIO_Pin, const bool isInverted)
             : PinDigital(pinName, GPIOx, GPIO_Pin, pinModeType::DIGITAL_IN, isInverted) {
         }
+
+#if defined(LIBSMART_STM32GPIO_ENABLE_PORT_SNAPSHOT) || defined(LIBSMART_STM32GPIO_ENABLE_EXTI) \
+    || defined(LIBSMART_STM32GPIO_ENABLE_DEBOUNCE)
+        /**
+         * @brief Check if the pin is currently on.
+         *
+         * With LIBSMART_STM32GPIO_ENABLE_PORT_SNAPSHOT, the pin is read from the port snapshot of the current
+         * loop tick. In interrupt mode, the state latched by the last handled edge is returned. If debouncing
+         * is enabled for the pin, the debounced state of the port is returned.
+         *
+         * @see PortSnapshot
+         * @see PortDebounce
+         * @return True if the pin is on, false otherwise.
+         */
+        bool isOn() override;
+
+        /**
+         * @brief Check if the pin is currently off.
+         *
+         * @see isOn()
+         * @return True if the pin is off, false otherwise.
+         */
+        bool isOff() override;
+#endif
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_DEBOUNCE
+        /**
+         * @brief Enable or disable debouncing of the pin.
+         *
+         * The port of the pin is registered with PortDebounce, which samples it every
+         * LIBSMART_STM32GPIO_DEBOUNCE_INTERVAL_MS milliseconds. A new level is reported by isOn(), after it has
+         * been stable for 4 (LIBSMART_STM32GPIO_DEBOUNCE_BITS 2) or 8 (LIBSMART_STM32GPIO_DEBOUNCE_BITS 3)
+         * samples. Call this method after setup().
+         *
+         * @param enable true to enable debouncing, false to read the raw pin.
+         */
+        void setDebounce(bool enable = true);
+
+        /**
+         * @brief Check if the pin is debounced.
+         *
+         * @return true if debouncing is enabled, false otherwise.
+         */
+        bool isDebounced() const { return debounced; }
+#endif
+
+        /**
+         * @brief Get the number of milliseconds, until the pin has work to do.
+         *
+         * A polled pin returns 0. In interrupt mode, the pin has no deadline, unless an edge is pending or
+         * its onChange callback is deferred.
+         *
+         * @see Pin::millisUntilNextDeadline()
+         */
+        uint32_t millisUntilNextDeadline() override;
+
+#if defined(LIBSMART_STM32GPIO_ENABLE_EXTI) && defined(HAL_EXTI_MODULE_ENABLED)
+        /**
+         * @brief Perform the looping actions for the PinDigitalIn class.
+         *
+         * In interrupt mode, the pin is not polled. Only edges latched by the interrupt are processed,
+         * and the pin reports itself idle to PinManager, as long as no edge is pending.
+         */
+        void loop() override;
+
+        /**
+         * @brief Switch the pin to interrupt mode.
+         *
+         * Configures the EXTI line of the pin for both edges and enables its interrupt. The pin has to be set
+         * up as input already. The EXTI interrupt handlers have to call Stm32Gpio_EXTI_IRQHandler().
+         *
+         * @return true on success, false if the EXTI line is already used by another pin.
+         */
+        bool enableInterrupt();
+
+        /**
+         * @brief Switch the pin back to polling mode.
+         */
+        void disableInterrupt();
+
+        /**
+         * @brief Check if the pin is in interrupt mode.
+         *
+         * @return true if the pin is in interrupt mode, false otherwise.
+         */
+        bool isInterruptEnabled() const { return interruptMode; }
+
+        /**
+         * @brief Latch an edge of the pin.
+         *
+         * This method is called by ExtiDispatcher in interrupt context and should not be called directly.
+         * It records the new level and the timestamp of the edge.
+         */
+        void handleInterrupt();
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_EDGE_EVENT_RING
+        /**
+         * @brief Apply an edge event, that was taken from the event ring.
+         *
+         * This method is called by ExtiDispatcher::drainEvents() in loop context and should not be called
+         * directly. It updates the pin state and calls the change handler.
+         *
+         * @param event The edge event.
+         */
+        void handleEdgeEvent(const EdgeEvent &event);
+
+        /**
+         * @brief Read the pin state from the port, after the event ring dropped edge events.
+         *
+         * This method is called by ExtiDispatcher::drainEvents() in loop context and should not be called
+         * directly. The dropped events may contain the last edge of the pin, so the pin state is taken from
+         * the port and the change handler is called.
+         */
+        void handleEventOverflow();
+#endif
+
+    private:
+        uint8_t getExtiLine() const { return static_cast<uint8_t>(__builtin_ctz(GPIO_Pin)); }
+
+        /**
+         * @brief Apply the edges latched by handleInterrupt() since the last call.
+         *
+         * @return true if edges were applied, false otherwise.
+         */
+        bool processLatchedEdges();
+
+        /**
+         * @brief Check if the interrupt has latched edges, that processLatchedEdges() has not applied yet.
+         *
+         * With LIBSMART_STM32GPIO_ENABLE_EDGE_EVENT_RING, the edges are queued in the ring instead.
+         */
+        bool isEdgePending() const {
+#ifdef LIBSMART_STM32GPIO_ENABLE_EDGE_EVENT_RING
+            return false;
+#else
+            return edgeCount != edgeCountProcessed;
+#endif
+        }
+
+        bool interruptMode = false;
+
+#ifndef LIBSMART_STM32GPIO_ENABLE_EDGE_EVENT_RING
+        /**
+         * @brief Number of edges latched by the interrupt. Only written in interrupt context.
+         */
+        volatile uint32_t edgeCount = 0;
+
+        /**
+         * @brief Number of edges processed by loop(). Only written in loop context.
+         */
+        uint32_t edgeCountProcessed = 0;
+
+        /**
+         * @brief Pin state after the last latched edge.
+         */
+        volatile bool edgeOn = false;
+
+        /**
+         * @brief Timestamp of the last latched edge, as returned by TimeBase::capture().
+         */
+        volatile uint32_t edgeCaptured = 0;
+#endif
+#endif
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_DEBOUNCE
+
+    private:
+        bool debounced = false;
+#endif
     };
 }
 
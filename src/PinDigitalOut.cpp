@@ -9,18 +9,90 @@ using namespace Stm32Gpio;
 
 void PinDigitalOut::setOn() {
     if (!setupDone) return;
+#if defined(LIBSMART_STM32GPIO_ENABLE_TIMER_BLINK) && defined(HAL_TIM_MODULE_ENABLED)
+    if (timerBlink) {
+        timerBlink = false;
+        outputValid = false;
+    }
+#endif
     fn = functionType::ON;
-    HAL_GPIO_WritePin(GPIOx, GPIO_Pin, inverted ? GPIO_PIN_RESET : GPIO_PIN_SET);
-    updatePinState();
+    wakeUp();
+    updateOutput(true);
 }
 
 void PinDigitalOut::setOff() {
     if (!setupDone) return;
+#if defined(LIBSMART_STM32GPIO_ENABLE_TIMER_BLINK) && defined(HAL_TIM_MODULE_ENABLED)
+    if (timerBlink) {
+        timerBlink = false;
+        outputValid = false;
+    }
+#endif
     fn = functionType::OFF;
-    HAL_GPIO_WritePin(GPIOx, GPIO_Pin, inverted ? GPIO_PIN_SET : GPIO_PIN_RESET);
+    wakeUp();
+    updateOutput(false);
+}
+
+void PinDigitalOut::setInverted(const bool newValue /* = true */) {
+    if (newValue == inverted) return;
+    PinDigital::setInverted(newValue);
+#if defined(LIBSMART_STM32GPIO_ENABLE_TIMER_BLINK) && defined(HAL_TIM_MODULE_ENABLED)
+    if (blinkTimer != nullptr) applyTimerPolarity();
+#endif
+    outputOn = !outputOn;
+    outputValid = false;
+    wakeUp();
+}
+
+void PinDigitalOut::updateOutput(const bool on) {
+    if (outputValid && (outputOn == on)) return;
+    writePin(on);
     updatePinState();
 }
 
+void PinDigitalOut::writePin(const bool on) {
+    outputOn = on;
+    outputValid = true;
+    if (_refreshMs != 0) lastWriteMs = millis();
+#if defined(LIBSMART_STM32GPIO_ENABLE_TIMER_BLINK) && defined(HAL_TIM_MODULE_ENABLED)
+    if (blinkTimer != nullptr) {
+        setOutputCompareMode(on ? TIM_OCMODE_FORCED_ACTIVE : TIM_OCMODE_FORCED_INACTIVE);
+        return;
+    }
+#endif
+#if defined(LIBSMART_STM32GPIO_ENABLE_OUTPUT_BATCHING)
+    PortOutputBatch::write(GPIOx, on ? bsrrOn : bsrrOff);
+#elif defined(LIBSMART_STM32GPIO_ENABLE_REGISTER_ACCESS)
+    GPIOx->BSRR = on ? bsrrOn : bsrrOff;
+#else
+    HAL_GPIO_WritePin(GPIOx, GPIO_Pin, (on != inverted) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+#endif
+}
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_OUTPUT_BATCHING
+
+bool PinDigitalOut::isOn() {
+#if __EXCEPTIONS
+    setupDone ? (void) 0 : throw "call setup() first";
+#endif
+#if defined(LIBSMART_STM32GPIO_ENABLE_TIMER_BLINK) && defined(HAL_TIM_MODULE_ENABLED)
+    if (blinkTimer != nullptr) return PinDigital::isOn();
+#endif
+    return (PortOutputBatch::read(GPIOx) & GPIO_Pin) == idrOn;
+}
+
+bool PinDigitalOut::isOff() {
+#if __EXCEPTIONS
+    setupDone ? (void) 0 : throw "call setup() first";
+#endif
+#if defined(LIBSMART_STM32GPIO_ENABLE_TIMER_BLINK) && defined(HAL_TIM_MODULE_ENABLED)
+    if (blinkTimer != nullptr) return PinDigital::isOff();
+#endif
+    return (PortOutputBatch::read(GPIOx) & GPIO_Pin) != idrOn;
+}
+
+#endif
+
 void PinDigitalOut::toggle() {
     if (!setupDone) return;
     fn == functionType::ON ? setOff() : setOn();
@@ -33,28 +105,128 @@ void PinDigitalOut::setBlink(uint32_t onMs, uint32_t offMs) {
     _offMs = offMs == 0 ? onMs : offMs;
     if (fn != functionType::BLINK) setOn();
     fn = functionType::BLINK;
+    wakeUp();
+#if defined(LIBSMART_STM32GPIO_ENABLE_TIMER_BLINK) && defined(HAL_TIM_MODULE_ENABLED)
+    if (blinkTimer != nullptr) {
+        timerBlink = startTimerBlink();
+    }
+#endif
+}
+
+#if defined(LIBSMART_STM32GPIO_ENABLE_TIMER_BLINK) && defined(HAL_TIM_MODULE_ENABLED)
+
+bool PinDigitalOut::setBlinkTimer(TIM_HandleTypeDef *htim, const uint32_t channel) {
+    if (!setupDone) return false;
+    if ((htim == blinkTimer) && (channel == blinkChannel)) return true;
+    blinkTimer = htim;
+    blinkChannel = channel;
+    timerBlink = false;
+
+    applyTimerPolarity();
+    writePin(outputOn);
+    if (HAL_TIM_PWM_Start(htim, channel) != HAL_OK) {
+        blinkTimer = nullptr;
+        outputValid = false;
+        return false;
+    }
+
+    if (fn == functionType::BLINK) timerBlink = startTimerBlink();
+    wakeUp();
+    return true;
+}
+
+void PinDigitalOut::applyTimerPolarity() const {
+    // The channel polarity takes care of the inverted flag, the output compare mode selects the logical state
+    if (inverted) {
+        blinkTimer->Instance->CCER |= TIM_CCER_CC1P << (blinkChannel & 0x1FU);
+    } else {
+        blinkTimer->Instance->CCER &= ~(TIM_CCER_CC1P << (blinkChannel & 0x1FU));
+    }
+}
+
+void PinDigitalOut::setOutputCompareMode(const uint32_t ocMode) const {
+    volatile uint32_t *ccmr = blinkChannel < TIM_CHANNEL_3 ? &blinkTimer->Instance->CCMR1
+                                                           : &blinkTimer->Instance->CCMR2;
+    const uint32_t shift = (blinkChannel & TIM_CHANNEL_2) != 0 ? 8 : 0;
+    *ccmr = (*ccmr & ~(TIM_CCMR1_OC1M << shift)) | (ocMode << shift);
 }
 
+bool PinDigitalOut::startTimerBlink() {
+    TimerTiming timing = {};
+    if (!TimerClock::calculateTiming(blinkTimer->Instance, _onMs + _offMs, 1000, timing)) return false;
+
+    const uint32_t ticks = timing.autoReload + 1;
+    setOutputCompareMode(TIM_OCMODE_FORCED_INACTIVE);
+    __HAL_TIM_SET_PRESCALER(blinkTimer, timing.prescaler);
+    __HAL_TIM_SET_AUTORELOAD(blinkTimer, timing.autoReload);
+    __HAL_TIM_SET_COMPARE(blinkTimer, blinkChannel,
+                          static_cast<uint32_t>(static_cast<uint64_t>(ticks) * _onMs / (_onMs + _offMs)));
+    // Load the prescaler and restart the period with the on phase
+    blinkTimer->Instance->EGR = TIM_EGR_UG;
+    setOutputCompareMode(TIM_OCMODE_PWM1);
+
+    // The pin is no longer driven by writePin()
+    outputValid = false;
+    return true;
+}
+
+#endif
+
 void PinDigitalOut::loop() {
-    PinDigital::loop();
+    Pin::loop();
     switch (fn) {
         case functionType::ON:
-            setOn();
+            updateOutput(true);
             break;
 
         case functionType::OFF:
-            setOff();
+            updateOutput(false);
             break;
 
         case functionType::BLINK:
-            if (isOn() && (millisSinceLastOn() >= _onMs)) {
-                setOff();
-            } else if (isOff() && (millisSinceLastOff() >= _offMs)) {
-                setOn();
+#if defined(LIBSMART_STM32GPIO_ENABLE_TIMER_BLINK) && defined(HAL_TIM_MODULE_ENABLED)
+            if (timerBlink) break;
+#endif
+            if (outputOn && (millisSinceLastOn() >= _onMs)) {
+                updateOutput(false);
+            } else if (!outputOn && (millisSinceLastOff() >= _offMs)) {
+                updateOutput(true);
             }
-            fn = functionType::BLINK;
             break;
     }
+
+    if ((_refreshMs != 0) && (getBlinkMode() != blinkModeType::TIMER) && ((millis() - lastWriteMs) >= _refreshMs)) {
+        writePin(outputOn);
+    }
+
+    if (isChangePending()) {
+        changeHandler();
+    }
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_TIMER_WHEEL
+    idleFor(hasLoopCallback() ? 0 : millisUntilNextDeadline());
+#else
+    loopIdle = (getBlinkMode() != blinkModeType::SOFTWARE) && (_refreshMs == 0) && !isChangePending()
+               && !hasLoopCallback();
+#endif
 }
 
+uint32_t PinDigitalOut::millisUntilNextDeadline() {
+    // The pin has to be rewritten, e.g. after setInverted()
+    if (!outputValid && (getBlinkMode() != blinkModeType::TIMER)) return 0;
+
+    uint32_t deadlineMs = PinDigital::millisUntilNextDeadline();
 
+    if (getBlinkMode() == blinkModeType::SOFTWARE) {
+        const uint32_t edgeMs = outputOn ? millisRemaining(millisSinceLastOn(), _onMs)
+                                         : millisRemaining(millisSinceLastOff(), _offMs);
+        if (edgeMs < deadlineMs) deadlineMs = edgeMs;
+    }
+
+    if ((_refreshMs != 0) && (getBlinkMode() != blinkModeType::TIMER)) {
+        const uint32_t refreshMs = millisRemaining(millis() - lastWriteMs, _refreshMs);
+        if (refreshMs < deadlineMs) deadlineMs = refreshMs;
+    }
+
+    return deadlineMs;
+}
@@ -8,9 +8,26 @@
 
 #include "PinDigital.hpp"
 
+#ifdef LIBSMART_STM32GPIO_ENABLE_OUTPUT_BATCHING
+#include "PortOutputBatch.hpp"
+#endif
+
+#if defined(LIBSMART_STM32GPIO_ENABLE_TIMER_BLINK) && defined(HAL_TIM_MODULE_ENABLED)
+#include "TimerClock.hpp"
+#endif
+
 namespace Stm32Gpio {
     class PinDigitalOut : public PinDigital {
     public:
+        using blinkModeType = enum class blinkModeType {
+            /** The pin is not blinking. */
+            OFF,
+            /** The pin is toggled by loop(). */
+            SOFTWARE,
+            /** The pin is toggled by the output compare unit of a timer. */
+            TIMER
+        };
+
         PinDigitalOut(GPIO_TypeDef *GPIOx, const uint16_t GPIO_Pin)
             : PinDigital(GPIOx, GPIO_Pin, pinModeType::DIGITAL_OUT) {
         }
@@ -31,17 +48,60 @@ namespace Stm32Gpio {
          * @brief Executes a loop iteration for the PinDigitalOut class.
          *
          * This method performs the necessary operations for a single iteration of the loop for the PinDigitalOut class.
-         * It calls the loop method of the base class PinDigital, and then checks the function type of the pin. Depending on the
+         * It calls the loop method of the base class Pin, and then checks the function type of the pin. Depending on the
          * function type, it performs specific actions.
+         *
+         * The pin is only written, if the commanded state or the blink phase changes, or if the refresh interval
+         * has elapsed. The pin state is only read back and evaluated after a write or while a change is pending.
+         * So a steady ON or OFF pin costs no register access per loop.
          */
         void loop() override;
 
+        /**
+         * @brief Set the inverted state and rewrite the pin with the new polarity on the next loop.
+         *
+         * @param newValue The new inverted state of the pin. The default value is true.
+         */
+        void setInverted(bool newValue = true) override;
+
+        /**
+         * @brief Set the interval to periodically rewrite the pin, even if the state did not change.
+         *
+         * This is useful for EMC-hardened deployments, where a disturbed output register should be restored
+         * after some time. The refresh does not read back the pin and does not trigger the change handler.
+         *
+         * @param refreshMs The refresh interval in milliseconds. 0 disables the refresh (default).
+         */
+        virtual void setRefreshInterval(const uint32_t refreshMs) {
+            _refreshMs = refreshMs;
+            wakeUp();
+        }
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_OUTPUT_BATCHING
+        /**
+         * @brief Check if the pin is on, according to the batched output image.
+         *
+         * This includes writes, that are not yet committed by PortOutputBatch::commit().
+         *
+         * @return True if the pin is on, false otherwise.
+         */
+        bool isOn() override;
+
+        /**
+         * @brief Check if the pin is off, according to the batched output image.
+         *
+         * @see isOn()
+         * @return True if the pin is off, false otherwise.
+         */
+        bool isOff() override;
+#endif
+
         /**
          * @brief Sets the pin state to ON for the PinDigitalOut class.
          *
          * This method sets the function type of the pin to 'ON' and writes the corresponding pin state to the hardware.
          * It checks if the pin setup has been done, and returns immediately if it hasn't.
-         * After setting the pin state, it calls the updatePinState() method.
+         * If the pin was written, it calls the updatePinState() method. If the pin is already on, nothing is written.
          */
         virtual void setOn();
 
@@ -50,7 +110,7 @@ namespace Stm32Gpio {
          *
          * This method sets the function type of the PinDigitalOut class to OFF and writes the appropriate state to the pin.
          * It first checks if the setup has been done. If not, it returns. Otherwise, it sets the function type to OFF,
-         * writes the pin state by calling HAL_GPIO_WritePin, and updates the pin state.
+         * and, if the pin is not already off, writes the pin state by calling writePin() and updates the pin state.
          */
         virtual void setOff();
 
@@ -81,12 +141,124 @@ namespace Stm32Gpio {
          */
         virtual void setBlink(uint32_t onMs, uint32_t offMs);
 
+        /**
+         * @brief Get the way the pin is blinking.
+         *
+         * @return blinkModeType::TIMER if the blink runs on a timer, blinkModeType::SOFTWARE if it is
+         * driven by loop(), blinkModeType::OFF if the pin is not blinking.
+         */
+        blinkModeType getBlinkMode() const {
+            if (fn != functionType::BLINK) return blinkModeType::OFF;
+#if defined(LIBSMART_STM32GPIO_ENABLE_TIMER_BLINK) && defined(HAL_TIM_MODULE_ENABLED)
+            if (timerBlink) return blinkModeType::TIMER;
+#endif
+            return blinkModeType::SOFTWARE;
+        }
+
+        /**
+         * @brief Get the number of milliseconds until the next blink edge, refresh or pending onChange callback.
+         *
+         * @see Pin::millisUntilNextDeadline()
+         */
+        uint32_t millisUntilNextDeadline() override;
+
+#if defined(LIBSMART_STM32GPIO_ENABLE_TIMER_BLINK) && defined(HAL_TIM_MODULE_ENABLED)
+        /**
+         * @brief Drive the pin by a timer channel.
+         *
+         * The pin has to be configured as output of the timer channel (e.g. TIM3_CH1) and the timer has to be
+         * initialized with HAL_TIM_PWM_Init(), as generated by CubeMX. From now on, setOn() and setOff() switch
+         * the channel between forced active and forced inactive mode, and setBlink() runs the blink in PWM
+         * mode without any CPU load and independent of the loop latency. If the blink period does not fit
+         * into the timer, the blink falls back to loop(), see getBlinkMode().
+         *
+         * The prescaler and the period of the timer are changed by setBlink(), so the timer must not be shared
+         * with other functions. The edges of a timer driven blink are not reported to the onChange callback.
+         *
+         * @param htim Pointer to the timer handle.
+         * @param channel The timer channel of the pin (TIM_CHANNEL_1 .. TIM_CHANNEL_4).
+         * @return true on success, false if the channel could not be started.
+         */
+        bool setBlinkTimer(TIM_HandleTypeDef *htim, uint32_t channel);
+#endif
+
+    protected:
+        /**
+         * @brief Drive the pin to the given logical state.
+         *
+         * With LIBSMART_STM32GPIO_ENABLE_OUTPUT_BATCHING the precomputed BSRR word is queued in PortOutputBatch.
+         * With LIBSMART_STM32GPIO_ENABLE_REGISTER_ACCESS it is stored to GPIOx->BSRR directly,
+         * otherwise HAL_GPIO_WritePin() is called.
+         *
+         * @param on True to drive the pin to the "on" state, false for the "off" state.
+         */
+        void writePin(bool on);
+
+        /**
+         * @brief Drive the pin to the given logical state, if it differs from the last written state.
+         *
+         * After a write, the pin state is updated by calling updatePinState().
+         *
+         * @param on True for the "on" state, false for the "off" state.
+         */
+        void updateOutput(bool on);
+
     private:
+#if defined(LIBSMART_STM32GPIO_ENABLE_TIMER_BLINK) && defined(HAL_TIM_MODULE_ENABLED)
+        /**
+         * @brief Set the polarity of the timer channel according to the inverted flag.
+         */
+        void applyTimerPolarity() const;
+
+        /**
+         * @brief Set the output compare mode of the timer channel.
+         *
+         * @param ocMode The output compare mode, e.g. TIM_OCMODE_PWM1.
+         */
+        void setOutputCompareMode(uint32_t ocMode) const;
+
+        /**
+         * @brief Start the blink on the timer.
+         *
+         * @return true if the blink runs on the timer, false if the period does not fit into the timer.
+         */
+        bool startTimerBlink();
+
+        TIM_HandleTypeDef *blinkTimer = nullptr;
+        uint32_t blinkChannel = 0;
+
+        /**
+         * @brief Indicates whether the current blink runs on the timer.
+         */
+        bool timerBlink = false;
+#endif
+
         using functionType = enum class functionType {
             OFF, ON, BLINK
         };
         functionType fn = functionType::OFF;
         uint32_t _onMs = 0, _offMs = 0;
+
+        /**
+         * @brief Shadow of the logical state, that was last written to the pin.
+         */
+        bool outputOn = false;
+
+        /**
+         * @brief Indicates whether outputOn reflects the hardware, i.e. the pin has been written at least once
+         * with the current polarity.
+         */
+        bool outputValid = false;
+
+        /**
+         * @brief Interval in milliseconds to rewrite a steady pin. 0 disables the refresh.
+         */
+        uint32_t _refreshMs = 0;
+
+        /**
+         * @brief Timestamp in milliseconds of the last write to the pin.
+         */
+        uint32_t lastWriteMs = 0;
     };
 }
 
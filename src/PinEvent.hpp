@@ -0,0 +1,46 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32GPIO_PINEVENT_HPP
+#define LIBSMART_STM32GPIO_PINEVENT_HPP
+
+#include <cstdint>
+
+namespace Stm32Gpio {
+    using pinEdgeType = enum class pinEdgeType : uint8_t {
+        /** The state did not change, e.g. on a forced onChange callback. */
+        NONE,
+        /** A digital pin changed to "on", or an analog value went up. */
+        RISING,
+        /** A digital pin changed to "off", or an analog value went down. */
+        FALLING
+    };
+
+    /**
+     * @struct PinEvent
+     * @brief Describes the change, that is reported to an onChange callback.
+     *
+     * The event is filled from the state, that was latched by the pin when the change was detected. So the
+     * callback does not have to read the pin again, and a newer edge can not slip in between.
+     */
+    struct PinEvent {
+        /** The new logical state of a digital pin. */
+        bool on;
+
+        /** The direction of the change. */
+        pinEdgeType edge;
+
+        /** The time of the change in milliseconds, as returned by millis(). */
+        uint32_t timestampMs;
+
+        /** The number of milliseconds between the previous change and this one. */
+        uint32_t sincePreviousMs;
+
+        /** The value of the pin: the ADC value of an analog input, the duty cycle of a PWM output, 0 or 1 otherwise. */
+        int32_t value;
+    };
+}
+
+#endif //LIBSMART_STM32GPIO_PINEVENT_HPP
@@ -0,0 +1,186 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "PinManager.hpp"
+#include "Pin.hpp"
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_PORT_SNAPSHOT
+#include "PortSnapshot.hpp"
+#endif
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_OUTPUT_BATCHING
+#include "PortOutputBatch.hpp"
+#endif
+
+#include "PortDebounce.hpp"
+
+#include "ExtiDispatcher.hpp"
+#include "TimeBase.hpp"
+
+using namespace Stm32Gpio;
+
+Pin *PinManager::first = nullptr;
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_TIMER_WHEEL
+Pin *PinManager::awakeFirst[LOOP_ORDERS] = {};
+Pin *PinManager::awakeLast[LOOP_ORDERS] = {};
+#endif
+
+void PinManager::setupAll() {
+    TimeBase::init();
+    for (Pin *pin = first; pin != nullptr; pin = pin->nextPin) {
+        pin->setup();
+    }
+}
+
+void PinManager::loopAll() {
+#ifdef LIBSMART_STM32GPIO_ENABLE_DWT_TIMEBASE
+    DwtTimeBase::now();
+#endif
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_PORT_SNAPSHOT
+    PortSnapshot::nextTick();
+#endif
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_DEBOUNCE
+    PortDebounce::sampleAll();
+#endif
+
+#if defined(LIBSMART_STM32GPIO_ENABLE_EXTI) && defined(HAL_EXTI_MODULE_ENABLED) && defined(LIBSMART_STM32GPIO_ENABLE_EDGE_EVENT_RING)
+    ExtiDispatcher::drainEvents();
+#endif
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_TIMER_WHEEL
+    TimerWheel::advance(millis());
+
+    // The ranks are looped one after the other, so an output, that is woken up by an input, is looped in the
+    // same iteration
+    for (uint8_t order = 0; order < LOOP_ORDERS; order++) {
+        // A pin, that wakes up again while the list is looped, is looped in the next iteration
+        const uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        Pin *pin = awakeFirst[order];
+        awakeFirst[order] = nullptr;
+        awakeLast[order] = nullptr;
+        __set_PRIMASK(primask);
+
+        while (pin != nullptr) {
+            Pin *next = pin->nextAwake;
+            // The pin sleeps after its loop, unless it wakes up again
+            pin->loopIdle = true;
+            pin->loop();
+            pin = next;
+        }
+    }
+#else
+    for (Pin *pin = first; pin != nullptr; pin = pin->nextPin) {
+        if (!pin->loopIdle) pin->loop();
+    }
+#endif
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_PORT_SNAPSHOT
+    PortSnapshot::endTick();
+#endif
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_OUTPUT_BATCHING
+    PortOutputBatch::commit();
+#endif
+}
+
+uint32_t PinManager::millisUntilNextDeadline() {
+#if defined(LIBSMART_STM32GPIO_ENABLE_EXTI) && defined(HAL_EXTI_MODULE_ENABLED) && defined(LIBSMART_STM32GPIO_ENABLE_EDGE_EVENT_RING)
+    if (!ExtiDispatcher::getEventRing().isEmpty()) return 0;
+#endif
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_TIMER_WHEEL
+    // Sleeping pins have scheduled their deadline in the wheel, awake pins have work right now
+    for (const Pin *pin: awakeFirst) {
+        if (pin != nullptr) return 0;
+    }
+    uint32_t deadlineMs = TimerWheel::millisUntilNextExpiry(millis());
+#else
+    uint32_t deadlineMs = Pin::NO_DEADLINE;
+    for (Pin *pin = first; pin != nullptr; pin = pin->nextPin) {
+        const uint32_t pinDeadlineMs = pin->hasLoopCallback() ? 0 : pin->millisUntilNextDeadline();
+        if (pinDeadlineMs == 0) return 0;
+        if (pinDeadlineMs < deadlineMs) deadlineMs = pinDeadlineMs;
+    }
+#endif
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_DWT_TIMEBASE
+    // loopAll() has to extend the cycle counter at least once per wrap
+    const uint32_t maxSleepMs = DwtTimeBase::millisPerWrap() / 2;
+    if (deadlineMs > maxSleepMs) deadlineMs = maxSleepMs;
+#endif
+    return deadlineMs;
+}
+
+void PinManager::releaseCancelledSubscriptions() {
+    for (Pin *pin = first; pin != nullptr; pin = pin->nextPin) {
+        pin->releaseCancelledSubscriptions();
+    }
+}
+
+void PinManager::add(Pin *pin) {
+    Pin **link = &first;
+    while ((*link != nullptr) && !pin->isLoopedBefore(*link)) {
+        link = &(*link)->nextPin;
+    }
+    pin->nextPin = *link;
+    *link = pin;
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_TIMER_WHEEL
+    // A new pin is looped at least once
+    pin->loopIdle = true;
+    wake(pin);
+#endif
+}
+
+void PinManager::remove(const Pin *pin) {
+#ifdef LIBSMART_STM32GPIO_ENABLE_TIMER_WHEEL
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    const uint8_t order = pin->getLoopOrder();
+    Pin *previous = nullptr;
+    for (Pin **link = &awakeFirst[order]; *link != nullptr; link = &(*link)->nextAwake) {
+        if (*link == pin) {
+            *link = pin->nextAwake;
+            if (awakeLast[order] == pin) awakeLast[order] = previous;
+            break;
+        }
+        previous = *link;
+    }
+    __set_PRIMASK(primask);
+#endif
+
+    for (Pin **link = &first; *link != nullptr; link = &(*link)->nextPin) {
+        if (*link == pin) {
+            *link = pin->nextPin;
+            return;
+        }
+    }
+}
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_TIMER_WHEEL
+
+void PinManager::wake(Pin *pin) {
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    // An interrupt may have woken up the pin in the meantime
+    if (pin->loopIdle) {
+        pin->loopIdle = false;
+        pin->nextAwake = nullptr;
+        const uint8_t order = pin->getLoopOrder();
+        if (awakeLast[order] == nullptr) {
+            awakeFirst[order] = pin;
+        } else {
+            awakeLast[order]->nextAwake = pin;
+        }
+        awakeLast[order] = pin;
+    }
+    __set_PRIMASK(primask);
+}
+
+#endif
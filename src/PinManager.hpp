@@ -0,0 +1,127 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32GPIO_PINMANAGER_HPP
+#define LIBSMART_STM32GPIO_PINMANAGER_HPP
+
+#include "libsmart_config.hpp"
+#include <cstdint>
+
+namespace Stm32Gpio {
+    class Pin;
+
+    /**
+     * @class PinManager
+     * @brief Registry of all pins, that allows to set up and loop them in a single call.
+     *
+     * Every Pin registers itself at construction in an intrusive singly linked list, so no heap is used.
+     * The list is kept sorted by pin type (inputs before outputs) and by GPIO port, so loopAll() processes
+     * pins of the same kind back to back.
+     *
+     * loopAll() skips pins, that reported to have no pending work (see Pin::isLoopIdle()). It also drives
+     * the per-port facilities: PortSnapshot::nextTick(), PortDebounce::sampleAll() and
+     * ExtiDispatcher::drainEvents() before and PortSnapshot::endTick() and PortOutputBatch::commit() after the
+     * pins, if they are enabled.
+     * With LIBSMART_STM32GPIO_ENABLE_TIMER_WHEEL, loopAll() does not walk the list of all pins. Pins with work
+     * to do are appended to an awake list (see Pin::wakeUp()): by their setters, by interrupts and by
+     * TimerWheel::advance(), when their next deadline (e.g. a blink edge or a deferred onChange callback) has
+     * come. loopAll() visits the awake pins only, so its cost does not depend on the number of sleeping pins.
+     */
+    class PinManager {
+    public:
+        PinManager() = delete;
+
+        /**
+         * @brief Number of ranks in the loop order of the pin types, see Pin::isLoopedBefore().
+         */
+        static constexpr uint8_t LOOP_ORDERS = 4;
+
+        /**
+         * @brief Initialize the time base and call setup() on all registered pins.
+         */
+        static void setupAll();
+
+        /**
+         * @brief Call loop() on all registered pins, that have pending work.
+         *
+         * This method is expected to be called in the main loop of the program, instead of calling
+         * loop() on every pin.
+         */
+        static void loopAll();
+
+        /**
+         * @brief Get the number of milliseconds, until the earliest deadline of all registered pins.
+         *
+         * The deadlines are blink edges, output refreshes, deferred or forced onChange callbacks and analog
+         * samples (see Pin::millisUntilNextDeadline()). Call this method after loopAll(). Until the returned
+         * time has passed, loopAll() has nothing to do, unless an interrupt (e.g. an EXTI edge) creates new work.
+         * So the application can sleep with WFI or enter Stop mode until then.
+         *
+         * A pin, that has to be polled (e.g. a PinDigitalIn without interrupt mode) or that has a loop callback,
+         * returns 0. With LIBSMART_STM32GPIO_ENABLE_TIMER_WHEEL, the pins are not asked. A non-empty awake list
+         * returns 0, otherwise the next expiry of the TimerWheel is returned.
+         *
+         * With LIBSMART_STM32GPIO_ENABLE_DWT_TIMEBASE, the result is limited to half the wrap period of the
+         * cycle counter (about 29 seconds at 72 MHz), because loopAll() has to extend it once per wrap.
+         *
+         * @return The number of milliseconds until the next deadline, 0 if loopAll() has to be called
+         * right away, Pin::NO_DEADLINE if there is no deadline at all.
+         */
+        static uint32_t millisUntilNextDeadline();
+
+        /**
+         * @brief Release the onChange subscriptions of all pins, that have been cancelled during a dispatch.
+         *
+         * This is called by Pin after the outermost dispatch and should not be called directly.
+         */
+        static void releaseCancelledSubscriptions();
+
+        /**
+         * @brief Register a pin.
+         *
+         * This is called by the Pin constructor and should not be called directly.
+         *
+         * @param pin The pin to register.
+         */
+        static void add(Pin *pin);
+
+        /**
+         * @brief Unregister a pin.
+         *
+         * This is called by the Pin destructor and should not be called directly.
+         *
+         * @param pin The pin to unregister.
+         */
+        static void remove(const Pin *pin);
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_TIMER_WHEEL
+        /**
+         * @brief Append a sleeping pin to the awake list, so loopAll() loops it.
+         *
+         * This is called by Pin::wakeUp(), also in interrupt context, and should not be called directly.
+         *
+         * @param pin The pin to wake up.
+         */
+        static void wake(Pin *pin);
+#endif
+
+    private:
+        static Pin *first;
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_TIMER_WHEEL
+        /**
+         * @brief Head of the awake list of each rank of the loop order.
+         */
+        static Pin *awakeFirst[LOOP_ORDERS];
+
+        /**
+         * @brief Tail of the awake list of each rank of the loop order, nullptr if the list is empty.
+         */
+        static Pin *awakeLast[LOOP_ORDERS];
+#endif
+    };
+}
+
+#endif //LIBSMART_STM32GPIO_PINMANAGER_HPP
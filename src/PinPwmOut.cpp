@@ -0,0 +1,90 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "PinPwmOut.hpp"
+
+#ifdef HAL_TIM_MODULE_ENABLED
+
+using namespace Stm32Gpio;
+
+void PinPwmOut::setup() {
+    Pin::setup();
+
+    // Preload compare and auto reload register, so updates take effect at the end of a period
+    volatile uint32_t *ccmr = channel < TIM_CHANNEL_3 ? &htim->Instance->CCMR1 : &htim->Instance->CCMR2;
+    *ccmr |= TIM_CCMR1_OC1PE << ((channel & TIM_CHANNEL_2) != 0 ? 8 : 0);
+    htim->Instance->CR1 |= TIM_CR1_ARPE;
+
+    updateDutyScale();
+    __HAL_TIM_SET_COMPARE(htim, channel, dutyToCompare(duty));
+    HAL_TIM_PWM_Start(htim, channel);
+}
+
+void PinPwmOut::loop() {
+    Pin::loop();
+    changeHandler();
+#ifdef LIBSMART_STM32GPIO_ENABLE_TIMER_WHEEL
+    idleFor(hasLoopCallback() ? 0 : millisUntilNextDeadline());
+#else
+    loopIdle = (duty == lastChangeHandlerDuty) && !isForcedOnChangeCallbackPending() && !hasLoopCallback();
+#endif
+}
+
+void PinPwmOut::setDuty(const uint16_t permille) {
+    if (!setupDone) return;
+    if (sequenceStarted) stopDutySequence();
+    duty = permille < DUTY_MAX ? permille : DUTY_MAX;
+    __HAL_TIM_SET_COMPARE(htim, channel, dutyToCompare(duty));
+    wakeUp();
+}
+
+bool PinPwmOut::setFrequency(const uint32_t frequencyHz) {
+    TimerTiming timing = {};
+    if (!TimerClock::calculateTiming(htim->Instance, 1, frequencyHz, timing)) return false;
+
+    __HAL_TIM_SET_PRESCALER(htim, timing.prescaler);
+    __HAL_TIM_SET_AUTORELOAD(htim, timing.autoReload);
+    updateDutyScale();
+    if (!sequenceStarted) __HAL_TIM_SET_COMPARE(htim, channel, dutyToCompare(duty));
+    return true;
+}
+
+void PinPwmOut::updateDutyScale() {
+    const uint64_t ticks = static_cast<uint64_t>(__HAL_TIM_GET_AUTORELOAD(htim)) + 1;
+    // As many fractional bits as possible (16 for 16 bit timers), so permille * dutyScale still fits 32 bits
+    static constexpr uint64_t scaleMax = UINT32_MAX / DUTY_MAX;
+    dutyShift = 16;
+    while ((dutyShift > 0) && (((ticks << dutyShift) / DUTY_MAX) > scaleMax)) dutyShift--;
+    dutyScale = static_cast<uint32_t>((ticks << dutyShift) / DUTY_MAX);
+    compareMax = static_cast<uint32_t>(ticks);
+}
+
+bool PinPwmOut::startDutySequence(const uint32_t *compareValues, const uint16_t length) {
+    if (!setupDone || (getDma() == nullptr) || (length == 0)) return false;
+    if (sequenceStarted) stopDutySequence();
+
+    // The channel keeps running, only the DMA request is added. As the compare register is preloaded, each
+    // value takes effect at the start of the next period, so the output does not glitch.
+    const auto src = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(compareValues));
+    const auto dst = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&htim->Instance->CCR1 + (channel >> 2)));
+    if (HAL_DMA_Start_IT(getDma(), src, dst, length) != HAL_OK) return false;
+    __HAL_TIM_ENABLE_DMA(htim, getDmaRequest());
+    sequenceStarted = true;
+    return true;
+}
+
+void PinPwmOut::stopDutySequence() {
+    if (!sequenceStarted) return;
+    __HAL_TIM_DISABLE_DMA(htim, getDmaRequest());
+    HAL_DMA_Abort(getDma());
+    sequenceStarted = false;
+    __HAL_TIM_SET_COMPARE(htim, channel, dutyToCompare(duty));
+}
+
+bool PinPwmOut::isDutySequenceRunning() const {
+    return sequenceStarted && (HAL_DMA_GetState(getDma()) == HAL_DMA_STATE_BUSY);
+}
+
+#endif
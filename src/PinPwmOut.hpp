@@ -0,0 +1,190 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32GPIO_PINPWMOUT_H
+#define LIBSMART_STM32GPIO_PINPWMOUT_H
+
+#include <libsmart_config.hpp>
+#include <main.h>
+
+#ifdef HAL_TIM_MODULE_ENABLED
+
+#include "Pin.hpp"
+#include "TimerClock.hpp"
+
+namespace Stm32Gpio {
+    /**
+     * @class PinPwmOut
+     * @brief A PWM output on a timer channel.
+     *
+     * The pin has to be configured as output of the timer channel and the timer has to be initialized for PWM
+     * generation (HAL_TIM_PWM_Init() and HAL_TIM_PWM_ConfigChannel(), as generated by CubeMX) before setup()
+     * is called.
+     *
+     * The duty cycle is set in permille. It is converted to a compare value with a scale factor, that is
+     * precomputed from the timer period, so no division is needed per update. The compare and the auto reload
+     * register are preloaded, so a new duty cycle or frequency takes effect at the next timer update and no
+     * truncated or doubled pulses are generated.
+     *
+     * A sequence of compare values can be fed by DMA, e.g. to run ramps and fades without CPU load.
+     */
+    class PinPwmOut : public Pin {
+    public:
+        static constexpr uint16_t DUTY_MAX = 1000;
+
+        PinPwmOut(TIM_HandleTypeDef *htim, const uint32_t channel)
+            : Pin(nullptr, 0, pinModeType::PWM_OUT), htim(htim), channel(channel) {
+        }
+
+        PinPwmOut(const char *pinName, TIM_HandleTypeDef *htim, const uint32_t channel)
+            : Pin(pinName, nullptr, 0, pinModeType::PWM_OUT), htim(htim), channel(channel) {
+        }
+
+        /**
+         * @brief Enable the preload registers and start the PWM output with a duty cycle of 0.
+         */
+        void setup() override;
+
+        /**
+         * @brief Perform the looping actions for the PinPwmOut class.
+         *
+         * Calls the loop callback and the onChange callback, if the duty cycle has changed. The pin reports
+         * itself idle to PinManager, as long as there is nothing to do.
+         */
+        void loop() override;
+
+        /**
+         * @brief Set the duty cycle.
+         *
+         * A running duty sequence is stopped.
+         *
+         * @param permille The duty cycle in permille (0 .. DUTY_MAX). Larger values are clipped.
+         */
+        void setDuty(uint16_t permille);
+
+        /**
+         * @brief Get the duty cycle, that was last set by setDuty().
+         *
+         * @return The duty cycle in permille.
+         */
+        uint16_t getDuty() const { return duty; }
+
+        /**
+         * @brief Set the PWM frequency.
+         *
+         * The prescaler and the period of the timer are changed, so this affects all channels of the timer.
+         * The duty cycle is kept.
+         *
+         * @param frequencyHz The PWM frequency in Hz.
+         * @return true on success, false if the frequency is out of the range of the timer.
+         */
+        bool setFrequency(uint32_t frequencyHz);
+
+        /**
+         * @brief Convert a duty cycle to the compare value of the timer.
+         *
+         * This can be used to fill the buffer for startDutySequence().
+         *
+         * @param permille The duty cycle in permille (0 .. DUTY_MAX).
+         * @return The compare value.
+         */
+        uint32_t dutyToCompare(const uint16_t permille) const {
+            if (permille >= DUTY_MAX) return compareMax;
+            return (permille * dutyScale) >> dutyShift;
+        }
+
+        /**
+         * @brief Feed the compare register from a buffer by DMA, one value per PWM period.
+         *
+         * A DMA channel has to be linked to the capture/compare request of the timer channel, with the memory
+         * data width set to word. If the DMA channel is in circular mode, the sequence repeats until
+         * stopDutySequence() or setDuty() is called. Otherwise the last value of the buffer remains active.
+         * The buffer has to stay valid while the sequence is running.
+         *
+         * The channel output stays enabled, only the DMA request of the channel is switched on. The compare
+         * register is preloaded (see setup()), so each value takes effect at the start of a period and the
+         * output does not glitch, when the sequence starts or stops.
+         *
+         * @param compareValues The compare values, see dutyToCompare().
+         * @param length The number of values in the buffer.
+         * @return true on success, false if no DMA channel is linked or the DMA could not be started.
+         */
+        bool startDutySequence(const uint32_t *compareValues, uint16_t length);
+
+        /**
+         * @brief Stop a running duty sequence and restore the duty cycle, that was set by setDuty().
+         */
+        void stopDutySequence();
+
+        /**
+         * @brief Check if a duty sequence is running.
+         *
+         * @return true if the DMA is feeding the compare register, false otherwise.
+         */
+        bool isDutySequenceRunning() const;
+
+        /**
+         * @brief Get the number of milliseconds, until a pending duty change may be reported.
+         *
+         * @see Pin::millisUntilNextDeadline()
+         */
+        uint32_t millisUntilNextDeadline() override {
+            return duty != lastChangeHandlerDuty ? millisUntilOnChangeCallback(true) : Pin::millisUntilNextDeadline();
+        }
+
+    protected:
+        bool hasChanged() override {
+            return Pin::hasChanged() || (duty != lastChangeHandlerDuty);
+        }
+
+        void resetChange() override {
+            Pin::resetChange();
+            lastChangeHandlerDuty = duty;
+        }
+
+        void describeChange(PinEvent &event) override {
+            Pin::describeChange(event);
+            event.on = duty != 0;
+            event.value = duty;
+            if (duty != lastChangeHandlerDuty) {
+                event.edge = duty > lastChangeHandlerDuty ? pinEdgeType::RISING : pinEdgeType::FALLING;
+            }
+        }
+
+    private:
+        /**
+         * @brief Precompute the scale factor from permille to compare value.
+         */
+        void updateDutyScale();
+
+        DMA_HandleTypeDef *getDma() const { return htim->hdma[TIM_DMA_ID_CC1 + (channel >> 2)]; }
+
+        /**
+         * @brief Get the capture/compare DMA request bit of the channel in the DIER register.
+         */
+        uint32_t getDmaRequest() const { return TIM_DMA_CC1 << (channel >> 2); }
+
+        TIM_HandleTypeDef *htim;
+        uint32_t channel;
+
+        /**
+         * @brief Compare value per permille, as fixed point number with dutyShift fractional bits.
+         */
+        uint32_t dutyScale = 0;
+        uint8_t dutyShift = 0;
+
+        /**
+         * @brief Compare value for a duty cycle of 100%.
+         */
+        uint32_t compareMax = 0;
+
+        uint16_t duty = 0;
+        uint16_t lastChangeHandlerDuty = 0;
+        bool sequenceStarted = false;
+    };
+}
+
+#endif
+#endif //LIBSMART_STM32GPIO_PINPWMOUT_H
@@ -0,0 +1,92 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "PortCapture.hpp"
+
+#if defined(HAL_TIM_MODULE_ENABLED) && defined(HAL_DMA_MODULE_ENABLED)
+
+#include "GpioPort.hpp"
+
+using namespace Stm32Gpio;
+
+bool PortCapture::setSampleFrequency(const uint32_t frequencyHz) {
+    TimerTiming timing = {};
+    if (!TimerClock::calculateTiming(htim->Instance, 1, frequencyHz, timing)) return false;
+
+    __HAL_TIM_SET_PRESCALER(htim, timing.prescaler);
+    __HAL_TIM_SET_AUTORELOAD(htim, timing.autoReload);
+    return true;
+}
+
+uint32_t PortCapture::getSamplePeriodNs() const {
+    const uint32_t clockHz = getClockHz();
+    return static_cast<uint32_t>((getSamplePeriodTicks() * 1000000000ull + clockHz / 2) / clockHz);
+}
+
+uint64_t PortCapture::getSamplePeriodTicks() const {
+    return (static_cast<uint64_t>(htim->Instance->PSC) + 1)
+           * (static_cast<uint64_t>(__HAL_TIM_GET_AUTORELOAD(htim)) + 1);
+}
+
+uint32_t PortCapture::getClockHz() const {
+    return TimerClock::getInputClock(htim->Instance);
+}
+
+bool PortCapture::start() {
+    if ((getDma() == nullptr) || (length == 0)) return false;
+    stop();
+    sampleCount = 0;
+    firstSample = 0;
+
+    __HAL_DMA_CLEAR_FLAG(getDma(), __HAL_DMA_GET_TC_FLAG_INDEX(getDma()));
+    const auto src = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&GPIOx->IDR));
+    const auto dst = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(buffer));
+    if (HAL_DMA_Start(getDma(), src, dst, length) != HAL_OK) return false;
+
+    __HAL_TIM_SET_COUNTER(htim, 0);
+    __HAL_TIM_ENABLE_DMA(htim, TIM_DMA_UPDATE);
+    __HAL_TIM_ENABLE(htim);
+    started = true;
+    return true;
+}
+
+void PortCapture::stop() {
+    __HAL_TIM_DISABLE_DMA(htim, TIM_DMA_UPDATE);
+    __HAL_TIM_DISABLE(htim);
+    if (!started) return;
+    started = false;
+
+    // The transfer complete flag tells, if the buffer has been filled (and overwritten in circular mode)
+    const uint16_t written = length - static_cast<uint16_t>(__HAL_DMA_GET_COUNTER(getDma()));
+    const bool wrapped = __HAL_DMA_GET_FLAG(getDma(), __HAL_DMA_GET_TC_FLAG_INDEX(getDma())) != 0;
+    HAL_DMA_Abort(getDma());
+
+    sampleCount = wrapped ? length : written;
+    firstSample = (wrapped && (written < length)) ? written : 0;
+}
+
+bool PortCapture::isRunning() const {
+    if (!started) return false;
+    // A DMA in normal mode stays busy in HAL, until it is aborted, so check the remaining transfers
+    return (getDma()->Init.Mode == DMA_CIRCULAR) || (__HAL_DMA_GET_COUNTER(getDma()) != 0);
+}
+
+uint16_t PortCapture::extractRuns(const uint16_t mask, CaptureRun *runs, const uint16_t maxRuns) const {
+    return getDecoder().extractRuns(mask, runs, maxRuns);
+}
+
+uint16_t PortCapture::extractEdges(const Pin &pin, bool &initialHigh, uint32_t *edgeSamples,
+                                   const uint16_t maxEdges) const {
+    initialHigh = false;
+    if (pin.getPort() != GPIOx) return 0;
+    return getDecoder().extractEdges(pin.getPinMask(), initialHigh, edgeSamples, maxEdges);
+}
+
+void PortCapture::exportVcd(const uint16_t mask, const textWriter writer, void *context) const {
+    const char portName = static_cast<char>('A' + GpioPort::index(GPIOx));
+    getDecoder().exportVcd(portName, mask, getSamplePeriodTicks(), getClockHz(), writer, context);
+}
+
+#endif
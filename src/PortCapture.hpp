@@ -0,0 +1,182 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32GPIO_PORTCAPTURE_HPP
+#define LIBSMART_STM32GPIO_PORTCAPTURE_HPP
+
+#include "libsmart_config.hpp"
+#include <main.h>
+
+#if defined(HAL_TIM_MODULE_ENABLED) && defined(HAL_DMA_MODULE_ENABLED)
+
+#include "Pin.hpp"
+#include "TimerClock.hpp"
+#include "CaptureDecoder.hpp"
+
+namespace Stm32Gpio {
+    /**
+     * @class PortCapture
+     * @brief Captures a whole GPIO port like a logic analyzer, by timer paced DMA transfers from GPIOx->IDR.
+     *
+     * Every update event of the timer triggers a DMA transfer of the input data register into the next half
+     * word of the buffer. So all pins of the port are sampled at a fixed rate without CPU load, much faster
+     * than loop() could poll them. If the DMA channel is in circular mode, the capture runs until stop() is
+     * called and the buffer holds the most recent samples. In normal mode, it stops when the buffer is full.
+     *
+     * The timer has to be initialized by CubeMX, and a DMA channel (peripheral to memory, half word width)
+     * has to be linked to its update request. On STM32F2/F4/F7, only DMA2 can access the GPIO ports.
+     *
+     * After the capture has stopped, the samples are compressed into runs of identical values
+     * (extractRuns()), decoded into the edges of a pin (extractEdges()), or exported as value change
+     * dump (exportVcd()). The evaluation is done by CaptureDecoder, getDecoder() gives direct access to it.
+     */
+    class PortCapture {
+    public:
+        /**
+         * @brief Receives the text of exportVcd() piece by piece.
+         */
+        using textWriter = CaptureDecoder::textWriter;
+
+        PortCapture() = delete;
+
+        /**
+         * @param htim Pointer to the timer handle, that paces the capture.
+         * @param GPIOx Pointer to the GPIO port register.
+         * @param buffer The buffer for the samples. It has to stay valid while the capture is running.
+         * @param length The number of samples in the buffer.
+         */
+        PortCapture(TIM_HandleTypeDef *htim, GPIO_TypeDef *GPIOx, uint16_t *buffer, const uint16_t length)
+            : htim(htim), GPIOx(GPIOx), buffer(buffer), length(length) {
+        }
+
+        /**
+         * @brief Set the sample rate.
+         *
+         * The prescaler and the period of the timer are changed.
+         *
+         * @param frequencyHz The number of samples per second.
+         * @return true on success, false if the frequency is out of the range of the timer.
+         */
+        bool setSampleFrequency(uint32_t frequencyHz);
+
+        /**
+         * @brief Get the time between two samples.
+         *
+         * The period is rounded to whole nanoseconds. Do not multiply it to get the time of a sample, use
+         * CaptureDecoder::sampleTimeNs() with getSamplePeriodTicks() and getClockHz() instead.
+         *
+         * @return The sample period in nanoseconds.
+         */
+        uint32_t getSamplePeriodNs() const;
+
+        /**
+         * @brief Get the exact time between two samples.
+         *
+         * @return The sample period in ticks of the timer clock.
+         */
+        uint64_t getSamplePeriodTicks() const;
+
+        /**
+         * @brief Get the clock of the timer, that paces the capture.
+         *
+         * @return The timer clock in Hz.
+         */
+        uint32_t getClockHz() const;
+
+        /**
+         * @brief Start a new capture.
+         *
+         * @return true on success, false if no DMA channel is linked to the update request of the timer or
+         * the DMA could not be started.
+         */
+        bool start();
+
+        /**
+         * @brief Stop the capture and freeze the buffer for the evaluation.
+         */
+        void stop();
+
+        /**
+         * @brief Check if the capture is running.
+         *
+         * @return true if the DMA is transferring samples, false otherwise.
+         */
+        bool isRunning() const;
+
+        /**
+         * @brief Get the number of valid samples of the stopped capture.
+         *
+         * @return The number of samples.
+         */
+        uint16_t getSampleCount() const { return sampleCount; }
+
+        /**
+         * @brief Get a sample of the stopped capture.
+         *
+         * @param index The index of the sample, 0 is the oldest sample.
+         * @return The value of GPIOx->IDR.
+         */
+        uint16_t getSample(const uint16_t index) const { return getDecoder().getSample(index); }
+
+        /**
+         * @brief Get a decoder for the stopped capture.
+         *
+         * @return The decoder. It refers to the buffer, so it is only valid until the next start().
+         */
+        CaptureDecoder getDecoder() const { return {buffer, length, firstSample, sampleCount}; }
+
+        /**
+         * @brief Compress the stopped capture into runs of identical values.
+         *
+         * The first run starts at sample 0, every further run starts at a change of the masked port value.
+         *
+         * @param mask The pins to evaluate, e.g. GPIO_PIN_0 | GPIO_PIN_3.
+         * @param runs Receives the runs.
+         * @param maxRuns Size of the runs array.
+         * @return The number of runs. If it equals maxRuns, the capture may have more runs.
+         */
+        uint16_t extractRuns(uint16_t mask, CaptureRun *runs, uint16_t maxRuns) const;
+
+        /**
+         * @brief Decode the edges of a pin from the stopped capture.
+         *
+         * The levels are the physical levels of the pin, the inverted flag is not applied.
+         *
+         * @param pin The pin. It has to be on the captured port.
+         * @param initialHigh Receives the level of the pin at sample 0.
+         * @param edgeSamples Receives the sample index of each edge.
+         * @param maxEdges Size of the edgeSamples array.
+         * @return The number of edges. 0 if the pin is on another port.
+         */
+        uint16_t extractEdges(const Pin &pin, bool &initialHigh, uint32_t *edgeSamples, uint16_t maxEdges) const;
+
+        /**
+         * @brief Export the stopped capture as value change dump (VCD).
+         *
+         * The pins are named after the port and pin number, e.g. PB5. The timestamps are in nanoseconds and
+         * calculated from the exact sample period. The output can be viewed with GTKWave, PulseView and similar
+         * tools.
+         *
+         * @param mask The pins to export.
+         * @param writer Receives the text.
+         * @param context Passed to the writer.
+         */
+        void exportVcd(uint16_t mask, textWriter writer, void *context) const;
+
+    private:
+        DMA_HandleTypeDef *getDma() const { return htim->hdma[TIM_DMA_ID_UPDATE]; }
+
+        TIM_HandleTypeDef *htim;
+        GPIO_TypeDef *GPIOx;
+        uint16_t *buffer;
+        uint16_t length;
+        uint16_t firstSample = 0;
+        uint16_t sampleCount = 0;
+        bool started = false;
+    };
+}
+
+#endif
+#endif //LIBSMART_STM32GPIO_PORTCAPTURE_HPP
@@ -0,0 +1,52 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "PortDebounce.hpp"
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_DEBOUNCE
+
+#include "Helper.hpp"
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_PORT_SNAPSHOT
+#include "PortSnapshot.hpp"
+#endif
+
+using namespace Stm32Gpio;
+
+VerticalCounter<LIBSMART_STM32GPIO_DEBOUNCE_BITS> PortDebounce::counters[GpioPort::count];
+GPIO_TypeDef *PortDebounce::ports[GpioPort::count] = {};
+uint16_t PortDebounce::usedMask = 0;
+uint32_t PortDebounce::lastSampleMs = 0;
+
+void PortDebounce::use(GPIO_TypeDef *GPIOx) {
+    const uint8_t idx = GpioPort::index(GPIOx);
+    if (usedMask & (1u << idx)) return;
+    ports[idx] = GPIOx;
+    counters[idx].reset(readPort(GPIOx));
+    usedMask |= 1u << idx;
+}
+
+void PortDebounce::sampleAll() {
+    const uint32_t now = millis();
+    if ((now - lastSampleMs) < LIBSMART_STM32GPIO_DEBOUNCE_INTERVAL_MS) return;
+    lastSampleMs = now;
+
+    uint16_t pending = usedMask;
+    while (pending != 0) {
+        const auto idx = static_cast<uint8_t>(__builtin_ctz(pending));
+        pending &= ~(1u << idx);
+        counters[idx].sample(readPort(ports[idx]));
+    }
+}
+
+uint16_t PortDebounce::readPort(GPIO_TypeDef *GPIOx) {
+#ifdef LIBSMART_STM32GPIO_ENABLE_PORT_SNAPSHOT
+    return PortSnapshot::read(GPIOx);
+#else
+    return static_cast<uint16_t>(GPIOx->IDR);
+#endif
+}
+
+#endif
@@ -0,0 +1,79 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32GPIO_PORTDEBOUNCE_HPP
+#define LIBSMART_STM32GPIO_PORTDEBOUNCE_HPP
+
+#include "GpioPort.hpp"
+#include "VerticalCounter.hpp"
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_DEBOUNCE
+
+/**
+ * Interval in milliseconds between two debounce samples of a port.
+ */
+#ifndef LIBSMART_STM32GPIO_DEBOUNCE_INTERVAL_MS
+#define LIBSMART_STM32GPIO_DEBOUNCE_INTERVAL_MS 5
+#endif
+
+/**
+ * Width of the vertical debounce counters (2: 4 samples, 3: 8 samples).
+ */
+#ifndef LIBSMART_STM32GPIO_DEBOUNCE_BITS
+#define LIBSMART_STM32GPIO_DEBOUNCE_BITS 2
+#endif
+
+namespace Stm32Gpio {
+    /**
+     * @class PortDebounce
+     * @brief Debounces whole GPIO ports with vertical counters.
+     *
+     * Ports are registered by the pins, that opt in to debouncing (see PinDigitalIn::setDebounce()).
+     * sampleAll() samples every registered port once per debounce interval and feeds the word into the
+     * vertical counter of the port. So all inputs of a port are debounced with a handful of bitwise
+     * operations per sample.
+     *
+     * PinManager::loopAll() calls sampleAll() on every loop iteration.
+     */
+    class PortDebounce {
+        static_assert(GpioPort::count <= 16, "used mask is 16 bit wide");
+
+    public:
+        PortDebounce() = delete;
+
+        /**
+         * @brief Register a port for debouncing.
+         *
+         * @param GPIOx Pointer to the GPIO port register.
+         */
+        static void use(GPIO_TypeDef *GPIOx);
+
+        /**
+         * @brief Sample all registered ports, if the debounce interval has elapsed.
+         */
+        static void sampleAll();
+
+        /**
+         * @brief Get the debounced input word of a port.
+         *
+         * @param GPIOx Pointer to the GPIO port register. The port has to be registered by use().
+         * @return The debounced value of GPIOx->IDR.
+         */
+        static uint16_t read(const GPIO_TypeDef *GPIOx) {
+            return counters[GpioPort::index(GPIOx)].getState();
+        }
+
+    private:
+        static uint16_t readPort(GPIO_TypeDef *GPIOx);
+
+        static VerticalCounter<LIBSMART_STM32GPIO_DEBOUNCE_BITS> counters[GpioPort::count];
+        static GPIO_TypeDef *ports[GpioPort::count];
+        static uint16_t usedMask;
+        static uint32_t lastSampleMs;
+    };
+}
+
+#endif
+#endif //LIBSMART_STM32GPIO_PORTDEBOUNCE_HPP
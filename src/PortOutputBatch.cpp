@@ -0,0 +1,32 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "PortOutputBatch.hpp"
+
+using namespace Stm32Gpio;
+
+GPIO_TypeDef *PortOutputBatch::ports[GpioPort::count] = {};
+uint16_t PortOutputBatch::shadow[GpioPort::count] = {};
+uint16_t PortOutputBatch::pendingSet[GpioPort::count] = {};
+uint16_t PortOutputBatch::pendingReset[GpioPort::count] = {};
+uint16_t PortOutputBatch::validMask = 0;
+uint16_t PortOutputBatch::dirtyMask = 0;
+
+void PortOutputBatch::commit() {
+    while (dirtyMask != 0) {
+        const auto idx = static_cast<uint8_t>(__builtin_ctz(dirtyMask));
+        dirtyMask &= ~(1u << idx);
+
+        const uint16_t current = shadow[idx];
+        const uint16_t next = (current & ~pendingReset[idx]) | pendingSet[idx];
+        pendingSet[idx] = 0;
+        pendingReset[idx] = 0;
+
+        const uint16_t changed = current ^ next;
+        if (changed == 0) continue;
+        ports[idx]->BSRR = (next & changed) | (static_cast<uint32_t>(current & changed) << 16u);
+        shadow[idx] = next;
+    }
+}
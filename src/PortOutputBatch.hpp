@@ -0,0 +1,87 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32GPIO_PORTOUTPUTBATCH_HPP
+#define LIBSMART_STM32GPIO_PORTOUTPUTBATCH_HPP
+
+#include "GpioPort.hpp"
+
+namespace Stm32Gpio {
+    /**
+     * @class PortOutputBatch
+     * @brief Collects output pin writes per port and commits them with one BSRR store per port.
+     *
+     * write() merges a BSRR word into the pending set and reset masks of the port. commit() applies the
+     * pending masks to the shadow output image of each port and writes only the bits, that actually differ,
+     * with a single 32-bit store to GPIOx->BSRR. So all pins on a port switch at the same instant and steady
+     * outputs do not cause any bus traffic.
+     *
+     * The shadow image of a port is initialized from GPIOx->ODR on the first write. All outputs on a batched
+     * port should be written through this class, otherwise the shadow image gets out of sync.
+     *
+     * commit() has to be called once at the end of every loop iteration.
+     */
+    class PortOutputBatch {
+        static_assert(GpioPort::count <= 16, "dirty and valid masks are 16 bit wide");
+
+    public:
+        PortOutputBatch() = delete;
+
+        /**
+         * @brief Queue a BSRR word for a port.
+         *
+         * The lower half of the word sets pins, the upper half resets pins. A later write to the same pin
+         * within the same tick overrides an earlier one.
+         *
+         * @param GPIOx Pointer to the GPIO port register.
+         * @param bsrr The BSRR word to queue.
+         */
+        static void write(GPIO_TypeDef *GPIOx, const uint32_t bsrr) {
+            const uint8_t idx = GpioPort::index(GPIOx);
+            prepare(idx, GPIOx);
+            const auto set = static_cast<uint16_t>(bsrr);
+            const auto reset = static_cast<uint16_t>(bsrr >> 16u);
+            pendingSet[idx] = (pendingSet[idx] & ~reset) | set;
+            pendingReset[idx] = (pendingReset[idx] & ~set) | reset;
+            dirtyMask |= 1u << idx;
+        }
+
+        /**
+         * @brief Get the output image of a port, including the writes not yet committed.
+         *
+         * @param GPIOx Pointer to the GPIO port register.
+         * @return The output data, as it will be after the next commit().
+         */
+        static uint16_t read(GPIO_TypeDef *GPIOx) {
+            const uint8_t idx = GpioPort::index(GPIOx);
+            prepare(idx, GPIOx);
+            return (shadow[idx] & ~pendingReset[idx]) | pendingSet[idx];
+        }
+
+        /**
+         * @brief Write all pending changes to the hardware.
+         *
+         * Issues one BSRR store for every port, whose output image differs from the shadow image.
+         */
+        static void commit();
+
+    private:
+        static void prepare(const uint8_t idx, GPIO_TypeDef *GPIOx) {
+            if (validMask & (1u << idx)) return;
+            ports[idx] = GPIOx;
+            shadow[idx] = static_cast<uint16_t>(GPIOx->ODR);
+            validMask |= 1u << idx;
+        }
+
+        static GPIO_TypeDef *ports[GpioPort::count];
+        static uint16_t shadow[GpioPort::count];
+        static uint16_t pendingSet[GpioPort::count];
+        static uint16_t pendingReset[GpioPort::count];
+        static uint16_t validMask;
+        static uint16_t dirtyMask;
+    };
+}
+
+#endif //LIBSMART_STM32GPIO_PORTOUTPUTBATCH_HPP
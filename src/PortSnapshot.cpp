@@ -0,0 +1,13 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "PortSnapshot.hpp"
+
+using namespace Stm32Gpio;
+
+uint32_t PortSnapshot::tick = 1;
+bool PortSnapshot::ticking = false;
+uint32_t PortSnapshot::latchedTick[GpioPort::count] = {};
+uint16_t PortSnapshot::latchedValue[GpioPort::count] = {};
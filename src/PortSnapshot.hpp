@@ -0,0 +1,71 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32GPIO_PORTSNAPSHOT_HPP
+#define LIBSMART_STM32GPIO_PORTSNAPSHOT_HPP
+
+#include "GpioPort.hpp"
+
+namespace Stm32Gpio {
+    /**
+     * @class PortSnapshot
+     * @brief Latches the input data register of each used GPIO port once per loop tick.
+     *
+     * The first read of a port within a tick reads GPIOx->IDR and stores the value. All further reads
+     * of the same port within this tick are served from the latched word. So all pins on a port see
+     * a consistent state and the peripheral bus is accessed only once per port and tick.
+     *
+     * PinManager::loopAll() opens a tick with nextTick() before the pins are looped and closes it with
+     * endTick() afterwards. Outside of a tick, e.g. if the application loops its pins by hand or reads a pin
+     * between two calls of loopAll(), read() reads the register on every call, so it never returns a stale
+     * value.
+     */
+    class PortSnapshot {
+    public:
+        PortSnapshot() = delete;
+
+        /**
+         * @brief Start a new loop tick.
+         *
+         * This method invalidates all latched port values. The next read of each port will read the
+         * hardware register again.
+         */
+        static void nextTick() {
+            ++tick;
+            ticking = true;
+        }
+
+        /**
+         * @brief End the current loop tick.
+         *
+         * Until the next call of nextTick(), read() does not latch the ports anymore.
+         */
+        static void endTick() { ticking = false; }
+
+        /**
+         * @brief Read the latched input data register of a port.
+         *
+         * @param GPIOx Pointer to the GPIO port register.
+         * @return The value of GPIOx->IDR, as latched in the current tick, or as read right now outside of a tick.
+         */
+        static uint16_t read(GPIO_TypeDef *GPIOx) {
+            if (!ticking) return static_cast<uint16_t>(GPIOx->IDR);
+            const uint8_t idx = GpioPort::index(GPIOx);
+            if (latchedTick[idx] != tick) {
+                latchedValue[idx] = static_cast<uint16_t>(GPIOx->IDR);
+                latchedTick[idx] = tick;
+            }
+            return latchedValue[idx];
+        }
+
+    private:
+        static uint32_t tick;
+        static bool ticking;
+        static uint32_t latchedTick[GpioPort::count];
+        static uint16_t latchedValue[GpioPort::count];
+    };
+}
+
+#endif //LIBSMART_STM32GPIO_PORTSNAPSHOT_HPP
@@ -0,0 +1,66 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "PortWaveform.hpp"
+
+#if defined(HAL_TIM_MODULE_ENABLED) && defined(HAL_DMA_MODULE_ENABLED)
+
+using namespace Stm32Gpio;
+
+void PortWaveform::clear() {
+    WaveformEncoder::clear(buffer, length);
+}
+
+bool PortWaveform::setLevel(const PinDigital &pin, const uint16_t step, const bool on) {
+    if (pin.getPort() != GPIOx) return false;
+    return WaveformEncoder::setLevel(buffer, length, pin.getBsrrOn(), pin.getBsrrOff(), step, on);
+}
+
+bool PortWaveform::addEdges(const PinDigital &pin, const bool initialOn, const uint16_t *edgeSteps,
+                            const uint16_t edgeCount) {
+    if (pin.getPort() != GPIOx) return false;
+    return WaveformEncoder::addEdges(buffer, length, pin.getBsrrOn(), pin.getBsrrOff(), initialOn, edgeSteps,
+                                     edgeCount);
+}
+
+bool PortWaveform::setStepFrequency(const uint32_t frequencyHz) {
+    TimerTiming timing = {};
+    if (!TimerClock::calculateTiming(htim->Instance, 1, frequencyHz, timing)) return false;
+
+    __HAL_TIM_SET_PRESCALER(htim, timing.prescaler);
+    __HAL_TIM_SET_AUTORELOAD(htim, timing.autoReload);
+    return true;
+}
+
+bool PortWaveform::start() {
+    if ((getDma() == nullptr) || (length == 0)) return false;
+    stop();
+
+    const auto src = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(buffer));
+    const auto dst = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&GPIOx->BSRR));
+    if (HAL_DMA_Start(getDma(), src, dst, length) != HAL_OK) {
+        return false;
+    }
+    __HAL_TIM_SET_COUNTER(htim, 0);
+    __HAL_TIM_ENABLE_DMA(htim, TIM_DMA_UPDATE);
+    __HAL_TIM_ENABLE(htim);
+    started = true;
+    return true;
+}
+
+void PortWaveform::stop() {
+    __HAL_TIM_DISABLE_DMA(htim, TIM_DMA_UPDATE);
+    __HAL_TIM_DISABLE(htim);
+    if ((getDma() != nullptr) && (HAL_DMA_GetState(getDma()) != HAL_DMA_STATE_READY)) HAL_DMA_Abort(getDma());
+    started = false;
+}
+
+bool PortWaveform::isRunning() const {
+    if (!started) return false;
+    // A DMA in normal mode stays busy in HAL, until it is aborted, so check the remaining transfers
+    return (getDma()->Init.Mode == DMA_CIRCULAR) || (__HAL_DMA_GET_COUNTER(getDma()) != 0);
+}
+
+#endif
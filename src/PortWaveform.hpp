@@ -0,0 +1,126 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32GPIO_PORTWAVEFORM_HPP
+#define LIBSMART_STM32GPIO_PORTWAVEFORM_HPP
+
+#include "libsmart_config.hpp"
+#include <main.h>
+
+#if defined(HAL_TIM_MODULE_ENABLED) && defined(HAL_DMA_MODULE_ENABLED)
+
+#include "PinDigital.hpp"
+#include "TimerClock.hpp"
+#include "WaveformEncoder.hpp"
+
+namespace Stm32Gpio {
+    /**
+     * @class PortWaveform
+     * @brief Generates multi-pin waveforms on a GPIO port by DMA transfers into GPIOx->BSRR.
+     *
+     * Every update event of the timer triggers a DMA transfer of the next 32 bit word from the buffer into the
+     * BSRR register of the port. So each word is one step of the waveform, and all pins of the port change at
+     * the same time. A word of 0 keeps all pins unchanged. The waveform runs at up to several MHz without CPU
+     * load and repeats, if the DMA channel is in circular mode.
+     *
+     * The timer has to be initialized by CubeMX, and a DMA channel (memory to peripheral, word width) has to be
+     * linked to its update request. On STM32F2/F4/F7, only DMA2 can access the GPIO ports.
+     *
+     * The buffer is composed from per-pin edge lists with addEdges(), or step by step with setLevel(). The
+     * BSRR words are taken from the pins, so the inverted flag of a pin is respected. The words are composed
+     * by WaveformEncoder.
+     */
+    class PortWaveform {
+    public:
+        PortWaveform() = delete;
+
+        /**
+         * @param htim Pointer to the timer handle, that paces the waveform.
+         * @param GPIOx Pointer to the GPIO port register.
+         * @param buffer The buffer for the BSRR words. It has to stay valid while the waveform is running.
+         * @param length The number of steps in the buffer.
+         */
+        PortWaveform(TIM_HandleTypeDef *htim, GPIO_TypeDef *GPIOx, uint32_t *buffer, const uint16_t length)
+            : htim(htim), GPIOx(GPIOx), buffer(buffer), length(length) {
+        }
+
+        /**
+         * @brief Fill the buffer with words, that keep all pins unchanged.
+         */
+        void clear();
+
+        /**
+         * @brief Drive a pin to the given state at a step.
+         *
+         * @param pin The pin. It has to be on the port of the waveform.
+         * @param step The step (0 .. length - 1).
+         * @param on True for the "on" state, false for the "off" state.
+         * @return true on success, false if the pin is on another port or the step is out of range.
+         */
+        bool setLevel(const PinDigital &pin, uint16_t step, bool on);
+
+        /**
+         * @brief Compose the waveform of a pin from its edges.
+         *
+         * The pin is driven to initialOn at step 0 and toggles at every step in edgeSteps. Other pins on the port
+         * are not affected, unless they change at the same step.
+         *
+         * @param pin The pin. It has to be on the port of the waveform.
+         * @param initialOn The state of the pin at step 0.
+         * @param edgeSteps The steps of the edges, in ascending order.
+         * @param edgeCount The number of edges.
+         * @return true on success, false if the pin is on another port or the steps are out of range or
+         * not ascending. The buffer is not changed in this case.
+         */
+        bool addEdges(const PinDigital &pin, bool initialOn, const uint16_t *edgeSteps, uint16_t edgeCount);
+
+        /**
+         * @brief Set the rate of the waveform steps.
+         *
+         * The prescaler and the period of the timer are changed.
+         *
+         * @param frequencyHz The number of steps per second.
+         * @return true on success, false if the frequency is out of the range of the timer.
+         */
+        bool setStepFrequency(uint32_t frequencyHz);
+
+        /**
+         * @brief Start the waveform at step 0.
+         *
+         * @return true on success, false if no DMA channel is linked to the update request of the timer or
+         * the DMA could not be started.
+         */
+        bool start();
+
+        /**
+         * @brief Stop the waveform. The pins keep their current state.
+         *
+         * A DMA channel, that is linked to the update request of the timer, is aborted.
+         */
+        void stop();
+
+        /**
+         * @brief Check if the waveform is running.
+         *
+         * @return true if the DMA is transferring words to the port, false otherwise.
+         */
+        bool isRunning() const;
+
+        uint32_t *getBuffer() const { return buffer; }
+        uint16_t getLength() const { return length; }
+
+    private:
+        DMA_HandleTypeDef *getDma() const { return htim->hdma[TIM_DMA_ID_UPDATE]; }
+
+        TIM_HandleTypeDef *htim;
+        GPIO_TypeDef *GPIOx;
+        uint32_t *buffer;
+        uint16_t length;
+        bool started = false;
+    };
+}
+
+#endif
+#endif //LIBSMART_STM32GPIO_PORTWAVEFORM_HPP
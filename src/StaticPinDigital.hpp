@@ -0,0 +1,272 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32GPIO_STATICPINDIGITAL_HPP
+#define LIBSMART_STM32GPIO_STATICPINDIGITAL_HPP
+
+#include "libsmart_config.hpp"
+#include <main.h>
+#include <cstdint>
+#include "Helper.hpp"
+
+#ifdef LIBSMART_ENABLE_STD_FUNCTION
+#ifdef LIBSMART_STM32GPIO_ENABLE_INPLACE_FUNCTION
+#include "InplaceFunction.hpp"
+#else
+#include <functional>
+#endif
+#endif
+
+namespace Stm32Gpio {
+    /**
+     * @class StaticPinDigital
+     * @brief A digital pin, whose port, pin number and polarity are known at compile time.
+     *
+     * This is the compile time counterpart of PinDigital. It has no virtual methods and keeps the port base
+     * address, the pin mask and the polarity in constexpr values. So isOn() compiles to a single load and test
+     * of the IDR register.
+     *
+     * The change detection follows the same rules as Pin::changeHandler(), including the deferred and forced
+     * onChange callbacks.
+     *
+     * @tparam PortBase Base address of the GPIO port, e.g. GPIOB_BASE.
+     * @tparam PinNo Number of the pin on the port (0..15).
+     * @tparam Inverted True, if the pin is active low.
+     */
+    template<uint32_t PortBase, uint8_t PinNo, bool Inverted = false>
+    class StaticPinDigital {
+        static_assert(PinNo < 16, "PinNo has to be in the range 0..15");
+
+    public:
+        static constexpr uint16_t pinMask = 1u << PinNo;
+        static constexpr uint32_t bsrrOn = Inverted ? (static_cast<uint32_t>(pinMask) << 16u) : pinMask;
+        static constexpr uint32_t bsrrOff = Inverted ? pinMask : (static_cast<uint32_t>(pinMask) << 16u);
+        static constexpr uint16_t idrOn = Inverted ? 0 : pinMask;
+
+        using onChangeCallback = void (*)(StaticPinDigital *pin);
+        using loopCallback = void (*)(StaticPinDigital *pin);
+
+        /**
+         * @brief Get the GPIO port register of this pin.
+         *
+         * @return Pointer to the GPIO port register.
+         */
+        static GPIO_TypeDef *port() { return reinterpret_cast<GPIO_TypeDef *>(PortBase); }
+
+        /**
+         * @brief Check if the pin is currently on.
+         *
+         * @return True if the pin is currently on, false otherwise.
+         */
+        bool isOn() const { return (port()->IDR & pinMask) == idrOn; }
+
+        /**
+         * @brief Check if the pin is currently off.
+         *
+         * @return True if the pin is currently off, false otherwise.
+         */
+        bool isOff() const { return (port()->IDR & pinMask) != idrOn; }
+
+        /**
+         * @brief Perform the looping actions.
+         *
+         * Calls the loop callback and updates the pin state, which may trigger the onChange callback.
+         * This method is expected to be called in the main loop of the program.
+         */
+        void loop() {
+            cb_loop != nullptr ? cb_loop(this) : (void) nullptr;
+#ifdef LIBSMART_ENABLE_STD_FUNCTION
+            fn_loop != nullptr ? fn_loop() : (void) nullptr;
+#endif
+            updatePinState();
+        }
+
+        void setOnChangeCallback(const onChangeCallback cb) { cb_onChange = cb; }
+        void setLoopCallback(const loopCallback cb) { cb_loop = cb; }
+
+#ifdef LIBSMART_ENABLE_STD_FUNCTION
+#ifdef LIBSMART_STM32GPIO_ENABLE_INPLACE_FUNCTION
+        using onChangeFunction = InplaceFunction<void()>;
+        using loopFunction = InplaceFunction<void()>;
+#else
+        using onChangeFunction = std::function<void()>;
+        using loopFunction = std::function<void()>;
+#endif
+        void setOnChangeCallback(const onChangeFunction &cb) { fn_onChange = cb; }
+        void setLoopCallback(const loopFunction &fn) { fn_loop = fn; }
+#endif
+
+        /**
+         * @brief Get the number of milliseconds since the last onChange callback was called.
+         *
+         * @see Pin::millisSinceLastOnChangeCallback()
+         */
+        uint32_t millisSinceLastOnChangeCallback() const { return millis() - lastOnChangeCallbackMs; }
+
+        /**
+         * @brief Set the defer time for the onChange callback.
+         *
+         * @see Pin::setDeferOnChangeCallback()
+         */
+        void setDeferOnChangeCallback(const uint32_t deferMs) { deferOnChangeCallbackMs = deferMs; }
+
+        /**
+         * @brief Force the onChange callback on the next loop iteration.
+         *
+         * @see Pin::setForceOnChangeCallback()
+         */
+        void setForceOnChangeCallback() { setForceOnChangeCallback(0); }
+
+        /**
+         * @brief Force the onChange callback, as soon as the given defer time has elapsed.
+         *
+         * @see Pin::setForceOnChangeCallback(uint32_t)
+         */
+        void setForceOnChangeCallback(const uint32_t deferMs) {
+            forceOnChangeCallback = true;
+            deferForcedOnChangeCallbackMs = deferMs;
+        }
+
+        uint32_t millisSinceLastOn() const { return millis() - lastChangeToOn; }
+        uint32_t millisSinceLastOff() const { return millis() - lastChangeToOff; }
+        uint32_t millisSinceLastChange() const { return lastLoopPinState ? millisSinceLastOn() : millisSinceLastOff(); }
+
+    protected:
+        /**
+         * @brief Update the state of the pin.
+         *
+         * Reads the pin once, stores the timestamps of the last change to on and off and
+         * calls changeHandler().
+         */
+        void updatePinState() {
+            const bool on = isOn();
+            if (on && !lastLoopPinState) {
+                lastChangeToOn = millis();
+            } else if (!on && lastLoopPinState) {
+                lastChangeToOff = millis();
+            }
+            lastLoopPinState = on;
+
+            changeHandler();
+        }
+
+        /**
+         * @brief Trigger the onChange callback if necessary.
+         *
+         * @see Pin::changeHandler()
+         */
+        void changeHandler() {
+            if ((millisSinceLastOnChangeCallback() >= deferOnChangeCallbackMs) && hasChanged()) {
+                forceOnChangeCallback = false;
+                deferForcedOnChangeCallbackMs = 0;
+                deferOnChangeCallbackMs = 0;
+                lastChangeHandlerPinState = lastLoopPinState;
+                cb_onChange != nullptr ? cb_onChange(this) : (void) nullptr;
+#ifdef LIBSMART_ENABLE_STD_FUNCTION
+                fn_onChange != nullptr ? fn_onChange() : (void) nullptr;
+#endif
+                if (deferOnChangeCallbackMs == 0) lastOnChangeCallbackMs = millis();
+            }
+        }
+
+        bool hasChanged() const {
+            return (forceOnChangeCallback && (millisSinceLastOnChangeCallback() >= deferForcedOnChangeCallbackMs))
+                   || (lastChangeHandlerPinState != lastLoopPinState);
+        }
+
+    private:
+        onChangeCallback cb_onChange = {};
+        loopCallback cb_loop = {};
+#ifdef LIBSMART_ENABLE_STD_FUNCTION
+        onChangeFunction fn_onChange = {};
+        loopFunction fn_loop = {};
+#endif
+        uint32_t lastOnChangeCallbackMs = 0;
+        uint32_t deferOnChangeCallbackMs = 0;
+        uint32_t deferForcedOnChangeCallbackMs = 0;
+        uint32_t lastChangeToOn = 0;
+        uint32_t lastChangeToOff = 0;
+        bool forceOnChangeCallback = true;
+        bool lastLoopPinState = false;
+        bool lastChangeHandlerPinState = false;
+    };
+
+
+    /**
+     * @class StaticPinDigitalIn
+     * @brief A digital input pin, that is fully resolved at compile time.
+     *
+     * @see StaticPinDigital
+     */
+    template<uint32_t PortBase, uint8_t PinNo, bool Inverted = false>
+    class StaticPinDigitalIn : public StaticPinDigital<PortBase, PinNo, Inverted> {
+    };
+
+
+    /**
+     * @class StaticPinDigitalOut
+     * @brief A digital output pin, that is fully resolved at compile time.
+     *
+     * setOn() and setOff() compile to a single store of a constant BSRR word. The resulting state change
+     * is evaluated by the next call of loop(). Unlike PinDigitalOut, steady ON and OFF states are not
+     * rewritten on every loop iteration.
+     *
+     * @see StaticPinDigital
+     */
+    template<uint32_t PortBase, uint8_t PinNo, bool Inverted = false>
+    class StaticPinDigitalOut : public StaticPinDigital<PortBase, PinNo, Inverted> {
+        using base = StaticPinDigital<PortBase, PinNo, Inverted>;
+
+    public:
+        /**
+         * @brief Perform the looping actions, including the software blink.
+         */
+        void loop() {
+            base::loop();
+            if (fn != functionType::BLINK) return;
+            if (base::isOn() && (base::millisSinceLastOn() >= _onMs)) {
+                base::port()->BSRR = base::bsrrOff;
+            } else if (base::isOff() && (base::millisSinceLastOff() >= _offMs)) {
+                base::port()->BSRR = base::bsrrOn;
+            }
+        }
+
+        void setOn() {
+            fn = functionType::ON;
+            base::port()->BSRR = base::bsrrOn;
+        }
+
+        void setOff() {
+            fn = functionType::OFF;
+            base::port()->BSRR = base::bsrrOff;
+        }
+
+        void toggle() {
+            fn == functionType::ON ? setOff() : setOn();
+        }
+
+        /**
+         * @brief Blink the pin from loop().
+         *
+         * @see PinDigitalOut::setBlink()
+         */
+        void setBlink(const uint32_t onMs, const uint32_t offMs = 0) {
+            if (onMs == 0) setOff();
+            _onMs = onMs;
+            _offMs = offMs == 0 ? onMs : offMs;
+            if (fn != functionType::BLINK) setOn();
+            fn = functionType::BLINK;
+        }
+
+    private:
+        using functionType = enum class functionType {
+            OFF, ON, BLINK
+        };
+        functionType fn = functionType::OFF;
+        uint32_t _onMs = 0, _offMs = 0;
+    };
+}
+
+#endif //LIBSMART_STM32GPIO_STATICPINDIGITAL_HPP
@@ -7,10 +7,35 @@
 #define LIBSMART_STM32GPIO_STM32GPIO_HPP
 
 #include "PinInterface.hpp"
+#include "PinEvent.hpp"
+#include "SubscriptionPool.hpp"
+#include "GpioPort.hpp"
+#include "TimeBase.hpp"
+#include "PortSnapshot.hpp"
+#include "PortOutputBatch.hpp"
+#include "TimerClock.hpp"
+#include "VerticalCounter.hpp"
+#include "PortDebounce.hpp"
+#include "TimerWheel.hpp"
+#include "InplaceFunction.hpp"
+#include "PinManager.hpp"
 #include "Pin.hpp"
 #include "PinDigital.hpp"
 #include "PinDigitalOut.hpp"
 #include "PinDigitalIn.hpp"
+#include "EdgeEventRing.hpp"
+#include "ExtiDispatcher.hpp"
+#include "AdcScanGroup.hpp"
+#include "AdcAsyncConverter.hpp"
+#include "AnalogFilter.hpp"
+#include "AnalogTransform.hpp"
 #include "PinAnalogIn.hpp"
+#include "PinAnalogInFiltered.hpp"
+#include "PinPwmOut.hpp"
+#include "WaveformEncoder.hpp"
+#include "PortWaveform.hpp"
+#include "CaptureDecoder.hpp"
+#include "PortCapture.hpp"
+#include "StaticPinDigital.hpp"
 
 #endif //LIBSMART_STM32GPIO_STM32GPIO_HPP
@@ -0,0 +1,37 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "SubscriptionPool.hpp"
+
+using namespace Stm32Gpio;
+
+ChangeSubscription SubscriptionPool::nodes[size] = {};
+ChangeSubscription *SubscriptionPool::freeList = nullptr;
+uint16_t SubscriptionPool::touchedCount = 0;
+uint16_t SubscriptionPool::usedCount = 0;
+uint8_t SubscriptionPool::dispatchDepth = 0;
+bool SubscriptionPool::cancelPending = false;
+
+ChangeSubscription *SubscriptionPool::allocate() {
+    ChangeSubscription *subscription;
+    if (freeList != nullptr) {
+        subscription = freeList;
+        freeList = subscription->next;
+    } else if (touchedCount < size) {
+        subscription = &nodes[touchedCount++];
+    } else {
+        return nullptr;
+    }
+    usedCount++;
+    *subscription = {};
+    return subscription;
+}
+
+void SubscriptionPool::release(ChangeSubscription *subscription) {
+    subscription->callback = nullptr;
+    subscription->next = freeList;
+    freeList = subscription;
+    usedCount--;
+}
@@ -0,0 +1,131 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32GPIO_SUBSCRIPTIONPOOL_HPP
+#define LIBSMART_STM32GPIO_SUBSCRIPTIONPOOL_HPP
+
+#include "libsmart_config.hpp"
+#include <cstdint>
+#include "PinEvent.hpp"
+
+/**
+ * Number of onChange subscriptions, that can exist at the same time, shared by all pins.
+ */
+#ifndef LIBSMART_STM32GPIO_SUBSCRIPTION_POOL_SIZE
+#define LIBSMART_STM32GPIO_SUBSCRIPTION_POOL_SIZE 8
+#endif
+
+namespace Stm32Gpio {
+    class PinInterface;
+
+    /**
+     * @struct ChangeSubscription
+     * @brief An onChange subscription of a pin, linked into the subscriber list of the pin.
+     *
+     * Subscriptions are taken from the SubscriptionPool by Pin::subscribe() and returned by Pin::unsubscribe().
+     */
+    struct ChangeSubscription {
+        using callbackType = void (*)(void *context, PinInterface *pin, const PinEvent &event);
+
+        /** The callback, nullptr if the subscription has been cancelled during a dispatch. */
+        callbackType callback;
+        void *context;
+        ChangeSubscription *next;
+
+        /** Subscriptions with a higher priority are called first. */
+        uint8_t priority;
+    };
+
+    /**
+     * @class SubscriptionPool
+     * @brief Static pool of onChange subscriptions, so subscribing never uses the heap.
+     *
+     * The pool also tracks, whether subscribers are being called. While a dispatch is running, cancelled
+     * subscriptions stay linked and are skipped, so the list, that is walked, never changes under the dispatch.
+     * A callback may cancel subscriptions of any pin, so after the outermost dispatch, the cancelled
+     * subscriptions of all pins are unlinked and returned to the pool, see
+     * PinManager::releaseCancelledSubscriptions().
+     */
+    class SubscriptionPool {
+    public:
+        SubscriptionPool() = delete;
+
+        static constexpr uint16_t size = LIBSMART_STM32GPIO_SUBSCRIPTION_POOL_SIZE;
+
+        /**
+         * @brief Take a subscription from the pool.
+         *
+         * @return The subscription, nullptr if the pool is exhausted.
+         */
+        static ChangeSubscription *allocate();
+
+        /**
+         * @brief Return a subscription to the pool.
+         *
+         * @param subscription The subscription, that must not be linked anymore.
+         */
+        static void release(ChangeSubscription *subscription);
+
+        /**
+         * @brief Get the number of subscriptions, that can still be allocated.
+         */
+        static uint16_t getFreeCount() { return size - usedCount; }
+
+        /**
+         * @brief Check if a pointer is a subscription of the pool.
+         *
+         * @param subscription The pointer, that may also hold a function of the same size, see Pin::onChangeSlot.
+         * @return true if the pointer points to a node of the pool, false otherwise.
+         */
+        static bool owns(const ChangeSubscription *subscription) {
+            const auto address = reinterpret_cast<uintptr_t>(subscription);
+            return (address >= reinterpret_cast<uintptr_t>(&nodes[0])) &&
+                   (address < reinterpret_cast<uintptr_t>(&nodes[size]));
+        }
+
+        /**
+         * @brief Check if subscribers are being called, possibly of another pin.
+         */
+        static bool isDispatching() { return dispatchDepth != 0; }
+
+        static void beginDispatch() { dispatchDepth++; }
+
+        static void endDispatch() { dispatchDepth--; }
+
+        /**
+         * @brief Cancel a subscription during a dispatch. It stays linked, until the dispatch has finished.
+         *
+         * @param subscription The subscription.
+         */
+        static void cancel(ChangeSubscription *subscription) {
+            subscription->callback = nullptr;
+            cancelPending = true;
+        }
+
+        /**
+         * @brief Check if subscriptions have been cancelled since the last call, and reset the indication.
+         */
+        static bool takeCancelPending() {
+            const bool pending = cancelPending;
+            cancelPending = false;
+            return pending;
+        }
+
+    private:
+        static ChangeSubscription nodes[size];
+        static ChangeSubscription *freeList;
+
+        /**
+         * @brief Number of nodes, that have ever been handed out from nodes[]. Nodes below are on the free list
+         * or in use.
+         */
+        static uint16_t touchedCount;
+        static uint16_t usedCount;
+        static uint8_t dispatchDepth;
+        static bool cancelPending;
+    };
+}
+
+#endif //LIBSMART_STM32GPIO_SUBSCRIPTIONPOOL_HPP
@@ -0,0 +1,15 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "TimeBase.hpp"
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_DWT_TIMEBASE
+
+using namespace Stm32Gpio;
+
+uint32_t DwtTimeBase::lastCycles = 0;
+uint32_t DwtTimeBase::highCycles = 0;
+
+#endif
@@ -0,0 +1,127 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32GPIO_TIMEBASE_HPP
+#define LIBSMART_STM32GPIO_TIMEBASE_HPP
+
+#include "libsmart_config.hpp"
+#include <main.h>
+#include <cstdint>
+#include "Helper.hpp"
+
+namespace Stm32Gpio {
+    /**
+     * @class MillisTimeBase
+     * @brief Time base with millisecond resolution, based on millis().
+     *
+     * capture() returns a timestamp, that can be taken in interrupt context and converted later.
+     */
+    class MillisTimeBase {
+    public:
+        MillisTimeBase() = delete;
+
+        static void init() {}
+
+        static uint32_t capture() { return millis(); }
+
+        static uint32_t toMillis(const uint32_t captured) { return captured; }
+    };
+
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_DWT_TIMEBASE
+    /**
+     * @class DwtTimeBase
+     * @brief High resolution time base, based on the DWT cycle counter of the Cortex-M core.
+     *
+     * The 32-bit CYCCNT register is extended to 64 bits in software, so the extended counter never wraps.
+     * The extension only works, if now() is called at least once per wrap of CYCCNT (about 59 seconds
+     * at 72 MHz). PinManager::loopAll() does this on every loop iteration.
+     *
+     * capture() returns the raw 32-bit counter. It can be called in interrupt context. The captured value
+     * can be extended later by extend(), as long as it is younger than one wrap period.
+     */
+    class DwtTimeBase {
+    public:
+        DwtTimeBase() = delete;
+
+        /**
+         * @brief Enable the cycle counter.
+         */
+        static void init() {
+            CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+            DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+        }
+
+        static uint32_t capture() { return DWT->CYCCNT; }
+
+        /**
+         * @brief Convert a captured cycle count to the millis() time base.
+         *
+         * @param captured A value returned by capture().
+         * @return The corresponding value of millis().
+         */
+        static uint32_t toMillis(const uint32_t captured) {
+            const uint32_t elapsed = DWT->CYCCNT - captured;
+            return millis() - static_cast<uint32_t>(static_cast<uint64_t>(elapsed) * 1000u / SystemCoreClock);
+        }
+
+        /**
+         * @brief Get the extended 64-bit cycle count. Must only be called in loop context.
+         *
+         * @return Number of cycles since init().
+         */
+        static uint64_t now() {
+            const uint32_t cycles = DWT->CYCCNT;
+            if (cycles < lastCycles) highCycles++;
+            lastCycles = cycles;
+            return (static_cast<uint64_t>(highCycles) << 32u) | cycles;
+        }
+
+        /**
+         * @brief Extend a captured 32-bit cycle count to 64 bits. Must only be called in loop context.
+         *
+         * @param captured A value returned by capture(), that is younger than one wrap period.
+         * @return The 64-bit cycle count at the time of the capture.
+         */
+        static uint64_t extend(const uint32_t captured) {
+            const uint64_t current = now();
+            return current - static_cast<uint32_t>(static_cast<uint32_t>(current) - captured);
+        }
+
+        /**
+         * @brief Convert a number of cycles to microseconds.
+         *
+         * The conversion is split into whole seconds and the remainder, so it neither overflows nor depends on
+         * the core clock being a multiple of 1 MHz.
+         *
+         * @param cycles The number of cycles.
+         * @return The number of microseconds.
+         */
+        static uint64_t cyclesToMicros(const uint64_t cycles) {
+            const uint32_t clock = SystemCoreClock;
+            return (cycles / clock) * 1000000u + (cycles % clock) * 1000000u / clock;
+        }
+
+        /**
+         * @brief Get the time, after which CYCCNT wraps.
+         *
+         * @return The wrap period in milliseconds.
+         */
+        static uint32_t millisPerWrap() {
+            return static_cast<uint32_t>((1ull << 32u) * 1000u / SystemCoreClock);
+        }
+
+    private:
+        static uint32_t lastCycles;
+        static uint32_t highCycles;
+    };
+
+    using TimeBase = DwtTimeBase;
+#else
+    using TimeBase = MillisTimeBase;
+#endif
+}
+
+#endif //LIBSMART_STM32GPIO_TIMEBASE_HPP
@@ -0,0 +1,52 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "TimerClock.hpp"
+
+#ifdef HAL_TIM_MODULE_ENABLED
+
+using namespace Stm32Gpio;
+
+uint32_t TimerClock::getInputClock(const TIM_TypeDef *TIMx) {
+    RCC_ClkInitTypeDef clkInit = {};
+    uint32_t flashLatency;
+    HAL_RCC_GetClockConfig(&clkInit, &flashLatency);
+
+#ifdef APB2PERIPH_BASE
+    if (reinterpret_cast<uintptr_t>(TIMx) >= APB2PERIPH_BASE) {
+        const uint32_t pclk = HAL_RCC_GetPCLK2Freq();
+        return clkInit.APB2CLKDivider == RCC_HCLK_DIV1 ? pclk : 2 * pclk;
+    }
+#else
+    (void) TIMx;
+#endif
+
+    const uint32_t pclk = HAL_RCC_GetPCLK1Freq();
+    return clkInit.APB1CLKDivider == RCC_HCLK_DIV1 ? pclk : 2 * pclk;
+}
+
+uint64_t TimerClock::getCounterRange(const TIM_TypeDef *TIMx) {
+    (void) TIMx; // Not used on families without 32 bit timers
+#ifdef IS_TIM_32B_COUNTER_INSTANCE
+    if (IS_TIM_32B_COUNTER_INSTANCE(TIMx)) return 0x100000000ull;
+#endif
+    return 0x10000ull;
+}
+
+bool TimerClock::calculateTiming(const TIM_TypeDef *TIMx, const uint32_t num, const uint32_t den,
+                                 TimerTiming &timing) {
+    if ((num == 0) || (den == 0)) return false;
+
+    const uint64_t ticks = static_cast<uint64_t>(getInputClock(TIMx)) * num / den;
+    const uint64_t range = getCounterRange(TIMx);
+    const uint64_t divider = (ticks + range - 1) / range;
+    if ((divider == 0) || (divider > 0x10000ull)) return false;
+
+    timing.prescaler = static_cast<uint32_t>(divider - 1);
+    timing.autoReload = static_cast<uint32_t>(ticks / divider - 1);
+    return true;
+}
+
+#endif
@@ -0,0 +1,66 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32GPIO_TIMERCLOCK_HPP
+#define LIBSMART_STM32GPIO_TIMERCLOCK_HPP
+
+#include "libsmart_config.hpp"
+#include <main.h>
+#include <cstdint>
+
+#ifdef HAL_TIM_MODULE_ENABLED
+
+namespace Stm32Gpio {
+    /**
+     * @brief Prescaler and auto reload value of a timer, as calculated by TimerClock::calculateTiming().
+     */
+    struct TimerTiming {
+        uint32_t prescaler;
+        uint32_t autoReload;
+    };
+
+    /**
+     * @class TimerClock
+     * @brief Helpers to derive timer settings from the current clock configuration.
+     */
+    class TimerClock {
+    public:
+        TimerClock() = delete;
+
+        /**
+         * @brief Get the input clock of a timer.
+         *
+         * The timers run at the clock of their APB bus, which is doubled, if the APB prescaler is not 1.
+         *
+         * @param TIMx Pointer to the timer register.
+         * @return The timer input clock in Hz.
+         */
+        static uint32_t getInputClock(const TIM_TypeDef *TIMx);
+
+        /**
+         * @brief Get the number of counter values of a timer.
+         *
+         * @param TIMx Pointer to the timer register.
+         * @return 2^32 for 32 bit timers, 2^16 otherwise.
+         */
+        static uint64_t getCounterRange(const TIM_TypeDef *TIMx);
+
+        /**
+         * @brief Calculate prescaler and auto reload value for a timer period of num / den seconds.
+         *
+         * The smallest prescaler is chosen, so the period has the best possible resolution.
+         *
+         * @param TIMx Pointer to the timer register.
+         * @param num Numerator of the period in seconds.
+         * @param den Denominator of the period in seconds.
+         * @param timing Receives the prescaler and the auto reload value.
+         * @return true on success, false if the period is out of the range of the timer.
+         */
+        static bool calculateTiming(const TIM_TypeDef *TIMx, uint32_t num, uint32_t den, TimerTiming &timing);
+    };
+}
+
+#endif
+#endif //LIBSMART_STM32GPIO_TIMERCLOCK_HPP
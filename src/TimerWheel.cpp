@@ -0,0 +1,116 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "TimerWheel.hpp"
+
+using namespace Stm32Gpio;
+
+TimerNode *TimerWheel::slots[LEVELS][SLOTS] = {};
+uint32_t TimerWheel::currentMs = 0;
+uint16_t TimerWheel::count = 0;
+
+void TimerWheel::schedule(TimerNode &node, const uint32_t expiresMs) {
+    cancel(node);
+    // The slot of currentMs has already been processed
+    node.expiresMs = static_cast<int32_t>(expiresMs - currentMs) > 0 ? expiresMs : currentMs + 1;
+    insert(node);
+    count++;
+}
+
+void TimerWheel::cancel(TimerNode &node) {
+    if (!node.isScheduled()) return;
+    *node.pprev = node.next;
+    if (node.next != nullptr) node.next->pprev = node.pprev;
+    node.next = nullptr;
+    node.pprev = nullptr;
+    count--;
+}
+
+void TimerWheel::advance(const uint32_t nowMs) {
+    if (count == 0) {
+        currentMs = nowMs;
+        return;
+    }
+
+    while (static_cast<int32_t>(nowMs - currentMs) > 0) {
+        currentMs++;
+
+        // At the start of a slot of a higher level, cascade its timers down, top level first
+        uint8_t level = 1;
+        while ((level < LEVELS) && ((currentMs & ((1u << (SLOT_BITS * level)) - 1)) == 0)) level++;
+        while (--level > 0) cascade(level);
+
+        TimerNode *node = slots[0][currentMs & (SLOTS - 1)];
+        slots[0][currentMs & (SLOTS - 1)] = nullptr;
+        while (node != nullptr) {
+            TimerNode *next = node->next;
+            node->next = nullptr;
+            node->pprev = nullptr;
+            count--;
+            node->expire(node->context);
+            node = next;
+        }
+        if (count == 0) {
+            currentMs = nowMs;
+            return;
+        }
+    }
+}
+
+uint32_t TimerWheel::millisUntilNextExpiry(const uint32_t nowMs) {
+    if (count == 0) return NO_EXPIRY;
+
+    // The slots of a level hold one block of 2^(SLOT_BITS * level) milliseconds each. The slot of the current
+    // block has already been cascaded, so the next block, that expires, is the first occupied one after it.
+    // The nodes of a block expire in any order, so all of them have to be compared.
+    bool found = false;
+    uint32_t nextMs = 0;
+    for (uint8_t level = 0; level < LEVELS; level++) {
+        const uint32_t block = currentMs >> (SLOT_BITS * level);
+        for (uint32_t offset = 1; offset <= SLOTS; offset++) {
+            const TimerNode *node = slots[level][(block + offset) & (SLOTS - 1)];
+            if (node == nullptr) continue;
+            for (; node != nullptr; node = node->next) {
+                if (!found || (static_cast<int32_t>(node->expiresMs - nextMs) < 0)) nextMs = node->expiresMs;
+                found = true;
+            }
+            break;
+        }
+    }
+
+    const uint32_t remainingMs = nextMs - nowMs;
+    return static_cast<int32_t>(remainingMs) > 0 ? remainingMs : 0;
+}
+
+void TimerWheel::insert(TimerNode &node) {
+    uint32_t delay = node.expiresMs - currentMs;
+    if (static_cast<int32_t>(delay) < 0) {
+        node.expiresMs = currentMs;
+        delay = 0;
+    } else if (delay > MAX_DELAY_MS) {
+        node.expiresMs = currentMs + MAX_DELAY_MS;
+        delay = MAX_DELAY_MS;
+    }
+
+    uint8_t level = 0;
+    while (delay >= (1u << (SLOT_BITS * (level + 1)))) level++;
+
+    TimerNode **head = &slots[level][(node.expiresMs >> (SLOT_BITS * level)) & (SLOTS - 1)];
+    node.next = *head;
+    if (node.next != nullptr) node.next->pprev = &node.next;
+    node.pprev = head;
+    *head = &node;
+}
+
+void TimerWheel::cascade(const uint8_t level) {
+    TimerNode **head = &slots[level][(currentMs >> (SLOT_BITS * level)) & (SLOTS - 1)];
+    TimerNode *node = *head;
+    *head = nullptr;
+    while (node != nullptr) {
+        TimerNode *next = node->next;
+        insert(*node);
+        node = next;
+    }
+}
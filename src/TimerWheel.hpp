@@ -0,0 +1,142 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32GPIO_TIMERWHEEL_HPP
+#define LIBSMART_STM32GPIO_TIMERWHEEL_HPP
+
+#include "libsmart_config.hpp"
+#include <cstdint>
+
+/**
+ * Number of slots per level of the timer wheel, as power of two (5: 32 slots).
+ */
+#ifndef LIBSMART_STM32GPIO_TIMER_WHEEL_SLOT_BITS
+#define LIBSMART_STM32GPIO_TIMER_WHEEL_SLOT_BITS 5
+#endif
+
+/**
+ * Number of levels of the timer wheel. The wheel covers deadlines up to 2^(SLOT_BITS * LEVELS) - 1 milliseconds
+ * (32767 ms with the defaults). Later deadlines wake the pin early, which then schedules the rest.
+ */
+#ifndef LIBSMART_STM32GPIO_TIMER_WHEEL_LEVELS
+#define LIBSMART_STM32GPIO_TIMER_WHEEL_LEVELS 3
+#endif
+
+namespace Stm32Gpio {
+    /**
+     * @struct TimerNode
+     * @brief Intrusive timer, that is embedded in the object, it belongs to.
+     *
+     * The node is linked into one slot of the TimerWheel while it is scheduled. When it expires, its callback
+     * is called with the context of its owner, e.g. a Pin appends itself to the awake list of PinManager.
+     */
+    struct TimerNode {
+        using expireCallback = void (*)(void *context);
+
+        TimerNode(const expireCallback expire, void *context) : expire(expire), context(context) {
+        }
+
+        /**
+         * @brief Check if the timer is linked into the wheel.
+         */
+        bool isScheduled() const { return pprev != nullptr; }
+
+        const expireCallback expire;
+        void *const context;
+        uint32_t expiresMs = 0;
+        TimerNode *next = nullptr;
+        TimerNode **pprev = nullptr;
+    };
+
+    /**
+     * @class TimerWheel
+     * @brief Hierarchical timer wheel with a resolution of one millisecond.
+     *
+     * Level 0 holds the timers, that expire within the next 2^SLOT_BITS milliseconds, one slot per millisecond.
+     * Each higher level covers 2^SLOT_BITS times the range of the level below. When the lower level wraps
+     * around, the timers of the next slot of the higher level are cascaded down. So scheduling and cancelling
+     * is O(1), and advance() only touches the timers, that actually expire or cascade.
+     *
+     * PinManager::loopAll() calls advance() before the pins are looped, so a pin, whose timer expired, is
+     * looped in the same iteration. Only the expired timers are touched, so the cost of a tick does not depend
+     * on the number of sleeping pins.
+     */
+    class TimerWheel {
+    public:
+        TimerWheel() = delete;
+
+        static constexpr uint8_t SLOT_BITS = LIBSMART_STM32GPIO_TIMER_WHEEL_SLOT_BITS;
+        static constexpr uint8_t LEVELS = LIBSMART_STM32GPIO_TIMER_WHEEL_LEVELS;
+        static constexpr uint32_t SLOTS = 1u << SLOT_BITS;
+        static_assert(SLOT_BITS * LEVELS < 32, "the wheel has to cover less than 2^32 milliseconds");
+
+        /**
+         * @brief The longest delay, the wheel can hold.
+         */
+        static constexpr uint32_t MAX_DELAY_MS = (1u << (SLOT_BITS * LEVELS)) - 1;
+
+        /**
+         * @brief Returned by millisUntilNextExpiry(), if no timer is scheduled.
+         */
+        static constexpr uint32_t NO_EXPIRY = UINT32_MAX;
+
+        /**
+         * @brief Schedule a timer. A scheduled timer is rescheduled.
+         *
+         * @param node The timer.
+         * @param expiresMs The time in milliseconds, as returned by millis(), when the timer expires.
+         * Deadlines in the past expire on the next tick.
+         */
+        static void schedule(TimerNode &node, uint32_t expiresMs);
+
+        /**
+         * @brief Remove a timer from the wheel, if it is scheduled.
+         *
+         * @param node The timer.
+         */
+        static void cancel(TimerNode &node);
+
+        /**
+         * @brief Advance the wheel to the given time and call the callbacks of all expired timers.
+         *
+         * An expired timer is unlinked before its callback is called, so the callback may schedule it again.
+         *
+         * This method is called by PinManager::loopAll() and should not be called directly.
+         *
+         * @param nowMs The current time in milliseconds, as returned by millis().
+         */
+        static void advance(uint32_t nowMs);
+
+        /**
+         * @brief Get the number of milliseconds, until the next timer expires.
+         *
+         * Only the first occupied slot of each level is inspected, so the cost does not depend on the number of
+         * scheduled timers. A timer, whose deadline was beyond MAX_DELAY_MS, is reported with the clamped
+         * deadline, when it wakes up its owner early.
+         *
+         * @param nowMs The current time in milliseconds, as returned by millis().
+         * @return The number of milliseconds until the next expiry, 0 if a timer is due, NO_EXPIRY if no timer
+         * is scheduled.
+         */
+        static uint32_t millisUntilNextExpiry(uint32_t nowMs);
+
+    private:
+        /**
+         * @brief Link a timer into the slot, that matches its distance from currentMs.
+         */
+        static void insert(TimerNode &node);
+
+        /**
+         * @brief Move the timers of the current slot of a level to the lower levels.
+         */
+        static void cascade(uint8_t level);
+
+        static TimerNode *slots[LEVELS][SLOTS];
+        static uint32_t currentMs;
+        static uint16_t count;
+    };
+}
+
+#endif //LIBSMART_STM32GPIO_TIMERWHEEL_HPP
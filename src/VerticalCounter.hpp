@@ -0,0 +1,68 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32GPIO_VERTICALCOUNTER_HPP
+#define LIBSMART_STM32GPIO_VERTICALCOUNTER_HPP
+
+#include <cstdint>
+
+namespace Stm32Gpio {
+    /**
+     * @class VerticalCounter
+     * @brief Debounces 16 inputs in parallel with vertical counters.
+     *
+     * Every bit position of the sample word has its own counter, whose bits are spread over the counter words
+     * (bit n of ct0, ct1, ct2 form the counter of input n). A counter is reset, as long as the input equals
+     * the debounced state, and counts otherwise. The debounced state of an input toggles, when its counter
+     * rolls over, i.e. after 4 (Bits = 2) or 8 (Bits = 3) consecutive samples with the new level.
+     *
+     * @tparam Bits Width of the counters, 2 or 3.
+     */
+    template<uint8_t Bits = 2>
+    class VerticalCounter {
+        static_assert((Bits == 2) || (Bits == 3), "Bits has to be 2 or 3");
+
+    public:
+        /**
+         * @brief Set the debounced state without debouncing, e.g. with the first sample.
+         *
+         * @param newState The new debounced state.
+         */
+        void reset(const uint16_t newState) {
+            state = newState;
+            ct0 = ct1 = ct2 = 0xFFFF;
+        }
+
+        /**
+         * @brief Feed a new sample.
+         *
+         * @param sample The raw input word.
+         * @return The debounced state.
+         */
+        uint16_t sample(const uint16_t sample) {
+            uint16_t changed = state ^ sample;
+            ct0 = ~(ct0 & changed);
+            ct1 = ct0 ^ (ct1 & changed);
+            if (Bits == 3) {
+                ct2 = (ct0 & ct1) ^ (ct2 & changed);
+                changed &= ct0 & ct1 & ct2;
+            } else {
+                changed &= ct0 & ct1;
+            }
+            state ^= changed;
+            return state;
+        }
+
+        uint16_t getState() const { return state; }
+
+    private:
+        uint16_t state = 0;
+        uint16_t ct0 = 0xFFFF;
+        uint16_t ct1 = 0xFFFF;
+        uint16_t ct2 = 0xFFFF;
+    };
+}
+
+#endif //LIBSMART_STM32GPIO_VERTICALCOUNTER_HPP
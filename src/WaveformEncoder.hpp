@@ -0,0 +1,86 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32GPIO_WAVEFORMENCODER_HPP
+#define LIBSMART_STM32GPIO_WAVEFORMENCODER_HPP
+
+#include <cstdint>
+
+namespace Stm32Gpio {
+    /**
+     * @class WaveformEncoder
+     * @brief Composes the BSRR words of a PortWaveform buffer.
+     *
+     * A pin is described by the two BSRR words, that switch it "on" and "off" (see PinDigital::getBsrrOn() and
+     * PinDigital::getBsrrOff()). So the encoder does not depend on the HAL, and the inverted flag of a pin is
+     * already contained in the words.
+     */
+    class WaveformEncoder {
+    public:
+        WaveformEncoder() = delete;
+
+        /**
+         * @brief Fill the buffer with words, that keep all pins unchanged.
+         *
+         * @param buffer The buffer.
+         * @param length The number of steps in the buffer.
+         */
+        static void clear(uint32_t *buffer, const uint16_t length) {
+            for (uint16_t i = 0; i < length; i++) {
+                buffer[i] = 0;
+            }
+        }
+
+        /**
+         * @brief Drive a pin to the given state at a step.
+         *
+         * @param buffer The buffer.
+         * @param length The number of steps in the buffer.
+         * @param bsrrOn The BSRR word, that switches the pin "on".
+         * @param bsrrOff The BSRR word, that switches the pin "off".
+         * @param step The step (0 .. length - 1).
+         * @param on True for the "on" state, false for the "off" state.
+         * @return true on success, false if the step is out of range.
+         */
+        static bool setLevel(uint32_t *buffer, const uint16_t length, const uint32_t bsrrOn, const uint32_t bsrrOff,
+                             const uint16_t step, const bool on) {
+            if (step >= length) return false;
+            // The set half of BSRR wins over the reset half, so the opposite bit has to be cleared
+            buffer[step] = (buffer[step] & ~(bsrrOn | bsrrOff)) | (on ? bsrrOn : bsrrOff);
+            return true;
+        }
+
+        /**
+         * @brief Compose the waveform of a pin from its edges.
+         *
+         * @param buffer The buffer.
+         * @param length The number of steps in the buffer.
+         * @param bsrrOn The BSRR word, that switches the pin "on".
+         * @param bsrrOff The BSRR word, that switches the pin "off".
+         * @param initialOn The state of the pin at step 0.
+         * @param edgeSteps The steps of the edges, in ascending order.
+         * @param edgeCount The number of edges.
+         * @return true on success, false if the steps are out of range or not ascending. The buffer is not
+         * changed in this case.
+         */
+        static bool addEdges(uint32_t *buffer, const uint16_t length, const uint32_t bsrrOn, const uint32_t bsrrOff,
+                             const bool initialOn, const uint16_t *edgeSteps, const uint16_t edgeCount) {
+            if (length == 0) return false;
+            for (uint16_t i = 0; i < edgeCount; i++) {
+                if ((edgeSteps[i] >= length) || ((i > 0) && (edgeSteps[i] <= edgeSteps[i - 1]))) return false;
+            }
+
+            bool on = initialOn;
+            setLevel(buffer, length, bsrrOn, bsrrOff, 0, on);
+            for (uint16_t i = 0; i < edgeCount; i++) {
+                on = !on;
+                setLevel(buffer, length, bsrrOn, bsrrOff, edgeSteps[i], on);
+            }
+            return true;
+        }
+    };
+}
+
+#endif //LIBSMART_STM32GPIO_WAVEFORMENCODER_HPP
@@ -11,4 +11,90 @@
 #undef LIBSMART_ENABLE_STD_FUNCTION
 #define LIBSMART_ENABLE_STD_FUNCTION
 
+/**
+ * Store the callbacks of LIBSMART_ENABLE_STD_FUNCTION in a fixed size InplaceFunction instead of std::function,
+ * so they never allocate. The capacity is set by LIBSMART_STM32GPIO_INPLACE_FUNCTION_CAPACITY.
+ * @see Stm32Gpio::InplaceFunction
+ */
+#undef LIBSMART_STM32GPIO_ENABLE_INPLACE_FUNCTION
+// #define LIBSMART_STM32GPIO_ENABLE_INPLACE_FUNCTION
+
+/**
+ * Access the GPIO registers (IDR/BSRR) directly instead of calling
+ * HAL_GPIO_ReadPin() and HAL_GPIO_WritePin().
+ */
+#undef LIBSMART_STM32GPIO_ENABLE_REGISTER_ACCESS
+// #define LIBSMART_STM32GPIO_ENABLE_REGISTER_ACCESS
+
+/**
+ * Serve PinDigitalIn reads from a per-port IDR snapshot, that is latched once per loop tick.
+ * @see Stm32Gpio::PortSnapshot
+ */
+#undef LIBSMART_STM32GPIO_ENABLE_PORT_SNAPSHOT
+// #define LIBSMART_STM32GPIO_ENABLE_PORT_SNAPSHOT
+
+/**
+ * Collect PinDigitalOut writes and commit them with one BSRR store per port and loop tick.
+ * @see Stm32Gpio::PortOutputBatch
+ */
+#undef LIBSMART_STM32GPIO_ENABLE_OUTPUT_BATCHING
+// #define LIBSMART_STM32GPIO_ENABLE_OUTPUT_BATCHING
+
+/**
+ * Enable the EXTI interrupt mode of PinDigitalIn.
+ * @see Stm32Gpio::PinDigitalIn::enableInterrupt()
+ */
+#undef LIBSMART_STM32GPIO_ENABLE_EXTI
+// #define LIBSMART_STM32GPIO_ENABLE_EXTI
 
+/**
+ * Define the EXTIx_IRQHandler functions in the library, so they do not have to be added to stm32xxxx_it.c.
+ * Do not enable this, if the EXTI interrupts are enabled in CubeMX.
+ */
+#undef LIBSMART_STM32GPIO_DEFINE_EXTI_IRQ_HANDLERS
+// #define LIBSMART_STM32GPIO_DEFINE_EXTI_IRQ_HANDLERS
+
+/**
+ * Pass EXTI edges through a lock-free ring buffer, that is drained by PinManager::loopAll().
+ * @see Stm32Gpio::EdgeEventRing
+ */
+#undef LIBSMART_STM32GPIO_ENABLE_EDGE_EVENT_RING
+// #define LIBSMART_STM32GPIO_ENABLE_EDGE_EVENT_RING
+
+/**
+ * Use the DWT cycle counter as high resolution time base for pin state changes.
+ * @see Stm32Gpio::DwtTimeBase
+ */
+#undef LIBSMART_STM32GPIO_ENABLE_DWT_TIMEBASE
+// #define LIBSMART_STM32GPIO_ENABLE_DWT_TIMEBASE
+
+/**
+ * Debounce input ports with vertical counters. Pins opt in with PinDigitalIn::setDebounce().
+ * @see Stm32Gpio::PortDebounce
+ */
+#undef LIBSMART_STM32GPIO_ENABLE_DEBOUNCE
+// #define LIBSMART_STM32GPIO_ENABLE_DEBOUNCE
+
+/**
+ * Allow PinDigitalOut to run setBlink() on a timer channel. Requires HAL_TIM_MODULE_ENABLED.
+ * @see Stm32Gpio::PinDigitalOut::setBlinkTimer()
+ */
+#undef LIBSMART_STM32GPIO_ENABLE_TIMER_BLINK
+// #define LIBSMART_STM32GPIO_ENABLE_TIMER_BLINK
+
+/**
+ * Define HAL_ADC_ConvCpltCallback() in the library, to pick up the results of AdcAsyncConverter in interrupt mode.
+ * Do not enable this, if HAL_ADC_ConvCpltCallback() is defined by the application.
+ * @see Stm32Gpio::AdcAsyncConverter
+ */
+#undef LIBSMART_STM32GPIO_DEFINE_ADC_CALLBACKS
+// #define LIBSMART_STM32GPIO_DEFINE_ADC_CALLBACKS
+
+
+/**
+ * Keep the deadlines of the pins (blink edges, refresh, deferred onChange callbacks) in a timer wheel, so pins
+ * with a pending deadline are not looped until it has come.
+ * @see Stm32Gpio::TimerWheel
+ */
+#undef LIBSMART_STM32GPIO_ENABLE_TIMER_WHEEL
+// #define LIBSMART_STM32GPIO_ENABLE_TIMER_WHEEL
@@ -0,0 +1,93 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Checks the fixed point filters of AnalogFilter.hpp with constant inputs, steps and dithered inputs,
+ * including chains, whose later stages see the wide output of an OversampleFilter.
+ */
+
+#include "AnalogFilter.hpp"
+#include "TestCheck.hpp"
+
+using namespace Stm32Gpio;
+
+namespace {
+    template<typename Filter>
+    uint32_t feedConstant(Filter &filter, const uint32_t sample, const uint32_t count) {
+        uint32_t output = 0;
+        for (uint32_t i = 0; i < count; i++) output = filter.filter(sample);
+        return output;
+    }
+
+    void testExponential() {
+        ExponentialFilter<3> filter;
+        // The first sample initializes the filter
+        CHECK_EQUAL(1000, filter.filter(1000));
+        // A step converges without a remaining offset
+        CHECK(filter.filter(2000) < 2000);
+        CHECK_EQUAL(2000, feedConstant(filter, 2000, 200));
+        CHECK_EQUAL(0, feedConstant(filter, 0, 200));
+    }
+
+    void testMovingAverage() {
+        MovingAverageFilter<4> filter;
+        CHECK_EQUAL(100, filter.filter(100));
+        CHECK_EQUAL(125, filter.filter(200));
+        CHECK_EQUAL(150, filter.filter(200));
+        CHECK_EQUAL(175, filter.filter(200));
+        CHECK_EQUAL(200, filter.filter(200));
+
+        // Values wider than 16 bits stay intact in the window
+        MovingAverageFilter<3> wide;
+        CHECK_EQUAL(200000, wide.filter(200000));
+        CHECK_EQUAL(170000, wide.filter(110000));
+        CHECK_EQUAL(140000, wide.filter(110000));
+        CHECK_EQUAL(110000, wide.filter(110000));
+    }
+
+    void testOversample() {
+        OversampleFilter<2> filter;
+        // Until the first decimation, the scaled sample is returned
+        CHECK_EQUAL(4000, filter.filter(1000));
+        // 16 samples alternating between 1000 and 1001 give half a step more resolution
+        for (uint32_t i = 1; i < OversampleFilter<2>::samplesPerOutput; i++) filter.filter(1000 + i % 2);
+        CHECK_EQUAL(4002, filter.filter(1000));
+    }
+
+    void testChainsWithWideStages() {
+        FilterChain<OversampleFilter<5>, MovingAverageFilter<4>> average;
+        CHECK_EQUAL(128000, feedConstant(average, 4000, 5000));
+
+        FilterChain<OversampleFilter<6>, ExponentialFilter<15>> exponential;
+        CHECK_EQUAL(256000, feedConstant(exponential, 4000, 5000));
+        CHECK_EQUAL(4095u << 6, feedConstant(exponential, 4095, 2000000));
+
+        FilterChain<OversampleFilter<6>, MovingAverageFilter<255>> longAverage;
+        CHECK_EQUAL(4095u << 6, feedConstant(longAverage, 4095, 5000));
+    }
+}
+
+namespace {
+    struct CustomFilter {
+        uint32_t filter(const uint32_t sample) { return sample * 3; }
+    };
+
+    static_assert(FilterExtraBits<ExponentialFilter<4>>::value == 0, "no extra bits");
+    static_assert(FilterExtraBits<MovingAverageFilter<8>>::value == 0, "no extra bits");
+    static_assert(FilterExtraBits<OversampleFilter<3>>::value == 3, "oversampling adds bits");
+    static_assert(FilterExtraBits<FilterChain<OversampleFilter<2>, ExponentialFilter<3>, OversampleFilter<1>>>::value
+                  == 3, "the extra bits of a chain add up");
+    static_assert(FilterExtraBits<CustomFilter>::value == unknownFilterScale, "unknown filter");
+    static_assert(FilterExtraBits<FilterChain<OversampleFilter<2>, CustomFilter>>::value == unknownFilterScale,
+                  "a chain with an unknown filter is unknown");
+}
+
+int main() {
+    testExponential();
+    testMovingAverage();
+    testOversample();
+    testChainsWithWideStages();
+    return 0;
+}
@@ -0,0 +1,50 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Compares the precomputed slope of LinearTransform with the 64 bit division of the former
+ * PinAnalogIn::calculateValue(). The host has a fast hardware divider, on a Cortex-M3 the 64 bit division
+ * is a library call and the difference is much larger.
+ */
+
+#include "AnalogTransform.hpp"
+#include <chrono>
+#include <cstdio>
+
+using namespace Stm32Gpio;
+
+namespace {
+    constexpr uint32_t rounds = 2000;
+
+    int8_t divisionCalculateValue(const uint32_t val) {
+        return (int8_t) ((110L * ((int64_t) val - 819L)) / (4096L - 819L));
+    }
+
+    template<typename Fn>
+    void measure(const char *name, Fn &&calculate) {
+        // Opaque to the optimizer, so the loop is not folded
+        volatile uint32_t mask = 0xFFF;
+        const auto start = std::chrono::steady_clock::now();
+        int32_t checksum = 0;
+        for (uint32_t round = 0; round < rounds; round++) {
+            for (uint32_t raw = 0; raw < 4096; raw++) checksum += calculate(raw & mask);
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        const double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+        std::printf("%-24s %6.2f ns/value (checksum %d)\n", name, ns / (rounds * 4096.0), checksum);
+    }
+}
+
+int main() {
+    static const LinearTransform transform(819, 0, 4096, 110);
+    const AnalogTransform &virtualTransform = transform;
+
+    measure("64 bit division", divisionCalculateValue);
+    measure("LinearTransform", [](const uint32_t raw) { return static_cast<int8_t>(transform.transform(raw)); });
+    measure("AnalogTransform virtual", [&](const uint32_t raw) {
+        return static_cast<int8_t>(virtualTransform.transform(raw));
+    });
+    return 0;
+}
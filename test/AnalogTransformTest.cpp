@@ -0,0 +1,85 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Compares the transforms of AnalogTransform.hpp with the exact integer division for every raw value of
+ * an 18 bit range, including lines, that are too steep for an exact fixed point slope.
+ */
+
+#include "AnalogTransform.hpp"
+#include "TestCheck.hpp"
+
+using namespace Stm32Gpio;
+
+namespace {
+    int64_t exactLine(const uint32_t raw, const uint32_t raw0, const int32_t value0, const uint32_t raw1,
+                      const int32_t value1) {
+        const int64_t rise = static_cast<int64_t>(value1) - value0;
+        const int64_t run = static_cast<int64_t>(raw1) - raw0;
+        return value0 + rise * (static_cast<int64_t>(raw) - raw0) / run;
+    }
+
+    void checkLine(const uint32_t raw0, const int32_t value0, const uint32_t raw1, const int32_t value1) {
+        const LinearTransform transform(raw0, value0, raw1, value1);
+        for (uint32_t raw = 0; raw < (1u << 18); raw++) {
+            const int64_t expected = exactLine(raw, raw0, value0, raw1, value1);
+            // The steep lines leave the range of the result early
+            if ((expected < INT32_MIN) || (expected > INT32_MAX)) continue;
+            if (transform.transform(raw) != expected) {
+                std::fprintf(stderr, "line (%u, %d) .. (%u, %d) at %u: %d != %lld\n", raw0, value0, raw1, value1,
+                             raw, transform.transform(raw), static_cast<long long>(expected));
+                std::exit(1);
+            }
+        }
+    }
+
+    void testLines() {
+        // The default percent transform of PinAnalogIn
+        checkLine(819, 0, 4096, 110);
+        // Steep lines, whose fixed point slope has only a few fractional bits
+        checkLine(0, 0, 3, 100000000);
+        checkLine(0, 0, 7, -300000000);
+        checkLine(1000, 5, 1003, 2000000000);
+        // Flat and falling lines, with points in both orders
+        checkLine(0, 0, 262143, 1);
+        checkLine(4095, -400, 0, 1250);
+        checkLine(100, 37, 7, 37);
+
+        CHECK_EQUAL(1066666666, LinearTransform(0, 0, 3, 100000000).transform(32));
+        // A vertical line stays at the first point
+        CHECK_EQUAL(42, LinearTransform(10, 42, 10, 50).transform(1000));
+    }
+
+    void testClamping() {
+        constexpr LinearTransform transform(0, 0, 4095, 1000, 100, 900);
+        CHECK_EQUAL(100, transform.transform(0));
+        CHECK_EQUAL(500, transform.transform(2048));
+        CHECK_EQUAL(900, transform.transform(4095));
+    }
+
+    void testPiecewise() {
+        constexpr uint32_t raws[] = {500, 1500, 2500, 3500};
+        constexpr int32_t values[] = {1200, 600, 250, -100};
+        constexpr PiecewiseLinearTransform<4> transform(raws, values);
+
+        CHECK_EQUAL(1200, transform.transform(0));
+        CHECK_EQUAL(-100, transform.transform(4095));
+        for (uint32_t raw = 500; raw <= 3500; raw++) {
+            const uint8_t i = raw < 1500 ? 0 : (raw < 2500 ? 1 : 2);
+            const int64_t line = exactLine(raw, raws[i], values[i], raws[i + 1], values[i + 1]);
+            CHECK_EQUAL(raw == 3500 ? -100 : line, transform.transform(raw));
+        }
+    }
+
+    // The slope is calculated at compile time
+    static_assert(LinearSegment(819, 0, 4096, 110).evaluate(4096) == 110, "constexpr evaluation");
+}
+
+int main() {
+    testLines();
+    testClamping();
+    testPiecewise();
+    return 0;
+}
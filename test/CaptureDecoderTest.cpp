@@ -0,0 +1,101 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Decodes a wrapped capture buffer with CaptureDecoder and compares the runs, the edges and the exported
+ * value change dump with the expected output.
+ */
+
+#include "CaptureDecoder.hpp"
+#include "TestCheck.hpp"
+#include <cstring>
+#include <string>
+
+using namespace Stm32Gpio;
+
+namespace {
+    void appendText(void *context, const char *text) {
+        static_cast<std::string *>(context)->append(text);
+    }
+
+    /**
+     * Samples 0 .. 5 in capture order, stored in a ring buffer, that wrapped at index 2.
+     * Pin 0 toggles at samples 1, 3 and 4, pin 2 goes high at sample 4, pin 7 is not evaluated.
+     */
+    const uint16_t wrappedBuffer[6] = {0x0085, 0x0085, 0x0000, 0x0081, 0x0081, 0x0080};
+
+    void testSamplesAndRuns() {
+        const CaptureDecoder decoder(wrappedBuffer, 6, 2, 6);
+        CHECK_EQUAL(6, decoder.getSampleCount());
+        CHECK_EQUAL(0x0000, decoder.getSample(0));
+        CHECK_EQUAL(0x0085, decoder.getSample(5));
+
+        CaptureRun runs[8];
+        CHECK_EQUAL(4, decoder.extractRuns(0x0005, runs, 8));
+        const CaptureRun expected[] = {{0, 0x0000}, {1, 0x0001}, {3, 0x0000}, {4, 0x0005}};
+        for (uint16_t i = 0; i < 4; i++) {
+            CHECK_EQUAL(expected[i].sample, runs[i].sample);
+            CHECK_EQUAL(expected[i].value, runs[i].value);
+        }
+        // The runs are cut at the size of the array
+        CHECK_EQUAL(2, decoder.extractRuns(0x0005, runs, 2));
+    }
+
+    void testEdges() {
+        const CaptureDecoder decoder(wrappedBuffer, 6, 2, 6);
+        bool initialHigh = true;
+        uint32_t edges[4];
+        CHECK_EQUAL(3, decoder.extractEdges(0x0001, initialHigh, edges, 4));
+        CHECK(!initialHigh);
+        CHECK_EQUAL(1, edges[0]);
+        CHECK_EQUAL(3, edges[1]);
+        CHECK_EQUAL(4, edges[2]);
+
+        const CaptureDecoder empty(wrappedBuffer, 6, 0, 0);
+        CHECK_EQUAL(0, empty.extractEdges(0x0001, initialHigh, edges, 4));
+        CHECK(!initialHigh);
+    }
+
+    void testSampleTime() {
+        // 24 MHz sample rate from a 72 MHz clock: 41.67 ns per sample
+        CHECK_EQUAL(41, CaptureDecoder::sampleTimeNs(1, 3, 72000000));
+        CHECK_EQUAL(125, CaptureDecoder::sampleTimeNs(3, 3, 72000000));
+        CHECK_EQUAL(2730625000000ull, CaptureDecoder::sampleTimeNs(65535, 3000000, 72000000));
+        // A 32-bit timer with the longest period does not overflow the calculation
+        const uint64_t longestPeriod = 65536ull * 4294967296ull;
+        const unsigned __int128 exactNs = static_cast<unsigned __int128>(65535 * longestPeriod) * 1000000000u / 72000000u;
+        CHECK(static_cast<uint64_t>(exactNs) == CaptureDecoder::sampleTimeNs(65535, longestPeriod, 72000000));
+    }
+
+    void testVcd() {
+        const CaptureDecoder decoder(wrappedBuffer, 6, 2, 6);
+        std::string vcd;
+        decoder.exportVcd('B', 0x0005, 3, 72000000, appendText, &vcd);
+        const char *expected =
+                "$timescale 1 ns $end\n"
+                "$scope module GPIOB $end\n"
+                "$var wire 1 ! PB0 $end\n"
+                "$var wire 1 # PB2 $end\n"
+                "$upscope $end\n"
+                "$enddefinitions $end\n"
+                "#0\n0!\n0#\n"
+                "#41\n1!\n"
+                "#125\n0!\n"
+                "#166\n1!\n1#\n"
+                "#250\n";
+        if (vcd != expected) {
+            std::fprintf(stderr, "unexpected VCD:\n%s", vcd.c_str());
+            std::exit(1);
+        }
+    }
+}
+
+int main() {
+    testSamplesAndRuns();
+    testEdges();
+    testSampleTime();
+    testVcd();
+    return 0;
+}
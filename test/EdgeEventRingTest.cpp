@@ -0,0 +1,117 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Runs a producer and a consumer of EdgeEventRing on two threads. The producer stands in for the EXTI
+ * interrupt, the consumer for ExtiDispatcher::drainEvents(). Each event carries a sequence number in the
+ * timestamp and check bits derived from it in pinIndex and level, so reordered, duplicated or torn events
+ * are detected.
+ */
+
+#include "EdgeEventRing.hpp"
+#include "TestCheck.hpp"
+#include <atomic>
+#include <initializer_list>
+#include <thread>
+
+using namespace Stm32Gpio;
+
+namespace {
+    constexpr uint32_t eventCount = 500000;
+
+    EdgeEvent makeEvent(const uint32_t sequence) {
+        return {sequence, static_cast<uint8_t>(sequence * 7u), static_cast<uint8_t>((sequence >> 3) & 1u)};
+    }
+
+    void checkEvent(const EdgeEvent &event) {
+        CHECK_EQUAL(static_cast<uint8_t>(event.timestamp * 7u), event.pinIndex);
+        CHECK_EQUAL((event.timestamp >> 3) & 1u, event.level);
+    }
+
+    template<edgeEventOverflowPolicyType Policy>
+    void stress(const uint16_t batchSize) {
+        EdgeEventRing<64, Policy> ring;
+        std::atomic<bool> producerDone{false};
+        uint32_t pushed = 0;
+        uint32_t rejected = 0;
+
+        std::thread producer([&] {
+            uint32_t sequence = 0;
+            for (uint32_t burst = 0; sequence < eventCount; burst++) {
+                // Bursts of 1..96 edges, most of them after the consumer has caught up, some of them overflow
+                if ((burst % 8) != 0) {
+                    while (ring.size() > 8) std::this_thread::yield();
+                }
+                const uint32_t length = (burst * 37u) % 96u + 1u;
+                for (uint32_t i = 0; (i < length) && (sequence < eventCount); i++, sequence++) {
+                    if (!ring.push(makeEvent(sequence))) rejected++;
+                    pushed++;
+                }
+            }
+            producerDone.store(true, std::memory_order_release);
+        });
+
+        uint32_t popped = 0;
+        int64_t lastSequence = -1;
+        EdgeEvent events[16];
+        for (;;) {
+            const bool done = producerDone.load(std::memory_order_acquire);
+            const uint16_t count = ring.popBatch(events, batchSize);
+            for (uint16_t i = 0; i < count; i++) {
+                checkEvent(events[i]);
+                // Events are delivered in order, dropped ones leave a gap
+                CHECK(static_cast<int64_t>(events[i].timestamp) > lastSequence);
+                lastSequence = events[i].timestamp;
+            }
+            popped += count;
+            if (count == 0) {
+                if (done) break;
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+
+        CHECK(ring.isEmpty());
+        CHECK_EQUAL(eventCount, pushed);
+        // Every event is either delivered or counted as overflow
+        CHECK_EQUAL(eventCount, popped + ring.getOverflowCount());
+        if (Policy == edgeEventOverflowPolicyType::DROP_NEWEST) {
+            CHECK_EQUAL(rejected, ring.getOverflowCount());
+        } else {
+            // The newest event is never dropped
+            CHECK_EQUAL(eventCount - 1, lastSequence);
+        }
+        CHECK(ring.getHighWaterMark() <= ring.capacity);
+        std::printf("policy %d, batch %2u: %u delivered, %u overflows, high water mark %u\n",
+                    static_cast<int>(Policy), batchSize, popped, ring.getOverflowCount(), ring.getHighWaterMark());
+    }
+
+    void testSingleThreaded() {
+        EdgeEventRing<4> newest;
+        for (uint32_t i = 0; i < 6; i++) newest.push(makeEvent(i));
+        CHECK_EQUAL(4, newest.size());
+        CHECK_EQUAL(2, newest.getOverflowCount());
+        CHECK_EQUAL(4, newest.getHighWaterMark());
+        EdgeEvent event = {};
+        CHECK(newest.pop(event));
+        CHECK_EQUAL(0, event.timestamp);
+
+        EdgeEventRing<4, edgeEventOverflowPolicyType::DROP_OLDEST> oldest;
+        for (uint32_t i = 0; i < 6; i++) oldest.push(makeEvent(i));
+        CHECK_EQUAL(4, oldest.size());
+        CHECK_EQUAL(2, oldest.getOverflowCount());
+        CHECK(oldest.pop(event));
+        CHECK_EQUAL(2, event.timestamp);
+    }
+}
+
+int main() {
+    testSingleThreaded();
+    for (const uint16_t batchSize: {1, 8, 16}) {
+        stress<edgeEventOverflowPolicyType::DROP_NEWEST>(batchSize);
+        stress<edgeEventOverflowPolicyType::DROP_OLDEST>(batchSize);
+    }
+    return 0;
+}
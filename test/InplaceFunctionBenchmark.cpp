@@ -0,0 +1,111 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Compares InplaceFunction with std::function: the size of the wrapper, the heap allocations and the time
+ * to construct and to call it. The numbers are from the host and only show the relation, the sizes on a
+ * 32 bit target are about half. The calls differ by a few instructions, so the benchmark is built with aligned
+ * functions and loops, otherwise the placement of the loops decides, which one is faster.
+ */
+
+#include "InplaceFunction.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+
+using namespace Stm32Gpio;
+
+namespace {
+    constexpr uint32_t iterations = 10000000;
+    uint32_t allocations = 0;
+    volatile int sink = 0;
+    int offset = 1;
+
+    template<typename Function>
+    Function makeFunction() {
+        volatile int *sinkPointer = &sink;
+        int *offsetPointer = &offset;
+        // Captures two pointers, like a callback with a context
+        return [sinkPointer, offsetPointer](const int value) {
+            *sinkPointer = value;
+            return value + *offsetPointer;
+        };
+    }
+
+    /**
+     * @brief Time the calls of a stored callback, that are checked against nullptr, as Pin::loop() calls fn_loop.
+     *
+     * The next call starts after the previous call has returned its result, so the time includes the passing of
+     * the argument and the result.
+     */
+    template<typename Function>
+    __attribute__((noinline)) double measureCall(const Function &function) {
+        int value = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < iterations; i++) {
+            value = function != nullptr ? function(value) : value;
+        }
+        const auto end = std::chrono::steady_clock::now();
+        sink = value;
+        return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    }
+
+    template<typename Function>
+    void measureConstruct(const char *name, const double callNs) {
+        const uint32_t allocationsBefore = allocations;
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < iterations; i++) {
+            Function function = makeFunction<Function>();
+            function(static_cast<int>(i));
+        }
+        const double constructNs = std::chrono::duration<double, std::nano>(
+                                       std::chrono::steady_clock::now() - start).count() / iterations;
+        const uint32_t constructAllocations = allocations - allocationsBefore;
+
+        std::printf("%-32s %4zu bytes %8.2f ns/construct %8.2f ns/call %8u allocations\n", name, sizeof(Function),
+                    constructNs, callNs, constructAllocations);
+    }
+}
+
+void *operator new(const std::size_t size) {
+    allocations++;
+    void *memory = std::malloc(size);
+    if (memory == nullptr) throw std::bad_alloc();
+    return memory;
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+
+void operator delete(void *memory, std::size_t) noexcept { std::free(memory); }
+
+int main() {
+    // The calls differ by a few instructions only, so both are timed alternately and the best run is taken
+    const auto standardFunction = makeFunction<std::function<int(int)>>();
+    const auto inplaceFunction = makeFunction<InplaceFunction<int(int)>>();
+    double standardCallNs = 0;
+    double inplaceCallNs = 0;
+    for (uint8_t run = 0; run < 10; run++) {
+        const double standardNs = measureCall(standardFunction);
+        const double inplaceNs = measureCall(inplaceFunction);
+        if ((run == 0) || (standardNs < standardCallNs)) standardCallNs = standardNs;
+        if ((run == 0) || (inplaceNs < inplaceCallNs)) inplaceCallNs = inplaceNs;
+    }
+
+    measureConstruct<std::function<int(int)>>("std::function<int(int)>", standardCallNs);
+    measureConstruct<InplaceFunction<int(int)>>("InplaceFunction<int(int)>", inplaceCallNs);
+
+    // Three pointers do not fit into the small buffer of std::function
+    const uint32_t before = allocations;
+    volatile int *sinkPointer = &sink;
+    int *a = &offset;
+    int *b = &offset;
+    const std::function<void(int)> large = [a, b, sinkPointer](const int v) { *sinkPointer = v + *a + *b; };
+    large(1);
+    std::printf("std::function with three captured pointers: %u allocation(s), "
+                "InplaceFunction rejects it at compile time, unless the capacity is raised\n", allocations - before);
+    return 0;
+}
@@ -0,0 +1,121 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Checks InplaceFunction with function pointers, capturing lambdas and a callable with a destructor, whose
+ * copies are counted, so leaked or double destroyed callables are detected.
+ */
+
+#include "InplaceFunction.hpp"
+#include "TestCheck.hpp"
+#include <utility>
+
+using namespace Stm32Gpio;
+
+namespace {
+    int doubled(const int value) { return 2 * value; }
+
+    int liveCounters = 0;
+
+    /**
+     * A callable, that is not trivially copyable.
+     */
+    struct CountingCallable {
+        explicit CountingCallable(int *calls) : calls(calls) { liveCounters++; }
+
+        CountingCallable(const CountingCallable &other) : calls(other.calls) { liveCounters++; }
+
+        CountingCallable(CountingCallable &&other) noexcept : calls(other.calls) { liveCounters++; }
+
+        ~CountingCallable() { liveCounters--; }
+
+        int operator()(const int value) const { return value + ++*calls; }
+
+        int *calls;
+    };
+
+    void testEmpty() {
+        const InplaceFunction<int(int)> defaulted;
+        CHECK(defaulted == nullptr);
+        CHECK(!defaulted);
+
+        const InplaceFunction<int(int)> fromNullptr = nullptr;
+        CHECK(fromNullptr == nullptr);
+
+        int (*nullFunction)(int) = nullptr;
+        const InplaceFunction<int(int)> fromNullFunction = nullFunction;
+        CHECK(fromNullFunction == nullptr);
+
+        InplaceFunction<int(int)> assigned = doubled;
+        CHECK(assigned != nullptr);
+        assigned = nullFunction;
+        CHECK(assigned == nullptr);
+        // Copies of an empty wrapper stay empty
+        const InplaceFunction<int(int)> copy = assigned;
+        CHECK(copy == nullptr);
+    }
+
+    void testCallables() {
+        const InplaceFunction<int(int)> function = doubled;
+        CHECK_EQUAL(42, function(21));
+
+        const InplaceFunction<int(int)> functionReference = &doubled;
+        CHECK_EQUAL(8, functionReference(4));
+
+        int offset = 5;
+        int *offsetPointer = &offset;
+        // Captures two pointers, the default capacity
+        const InplaceFunction<int(int)> lambda = [offsetPointer, &offset](const int value) {
+            return value + *offsetPointer + offset;
+        };
+        CHECK_EQUAL(11, lambda(1));
+        offset = 7;
+        CHECK_EQUAL(15, lambda(1));
+
+        // A mutable lambda keeps its state in the wrapper
+        const InplaceFunction<int()> counter = [count = 0]() mutable { return ++count; };
+        CHECK_EQUAL(1, counter());
+        CHECK_EQUAL(2, counter());
+    }
+
+    void testLifetime() {
+        int calls = 0;
+        {
+            InplaceFunction<int(int)> first = CountingCallable(&calls);
+            CHECK_EQUAL(1, liveCounters);
+            CHECK_EQUAL(11, first(10));
+
+            InplaceFunction<int(int)> second = first;
+            CHECK_EQUAL(2, liveCounters);
+            CHECK_EQUAL(12, second(10));
+
+            InplaceFunction<int(int)> third = std::move(first);
+            CHECK(first == nullptr);
+            CHECK_EQUAL(2, liveCounters);
+
+            // Replacing and resetting destroy the stored callable
+            second = doubled;
+            CHECK_EQUAL(1, liveCounters);
+            CHECK_EQUAL(6, second(3));
+            third = nullptr;
+            CHECK_EQUAL(0, liveCounters);
+
+            third = CountingCallable(&calls);
+            first = third;
+            second = std::move(third);
+            CHECK_EQUAL(2, liveCounters);
+            CHECK_EQUAL(13, first(10));
+            CHECK_EQUAL(14, second(10));
+        }
+        CHECK_EQUAL(0, liveCounters);
+    }
+}
+
+int main() {
+    testEmpty();
+    testCallables();
+    testLifetime();
+    return 0;
+}
@@ -0,0 +1,123 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Compares the two ways PinDigital::isOn() and PinDigitalOut::writePin() access a pin on the host register
+ * file of host/main.h: "HAL" calls HAL_GPIO_ReadPin() and HAL_GPIO_WritePin() and evaluates the inverted
+ * flag on every access, "register" reads IDR and writes BSRR with the masks, that PinDigital precomputes in
+ * updateRegisterMasks() (LIBSMART_STM32GPIO_ENABLE_REGISTER_ACCESS).
+ *
+ * Both paths are copies of the two branches of the library code, because the configuration of the library
+ * is fixed at build time. Both access the bus once per call, the difference is the call into the HAL and the
+ * polarity evaluation around it.
+ */
+
+#include <main.h>
+#include <chrono>
+#include <cstdio>
+
+namespace {
+    constexpr uint32_t iterations = 2000000;
+    constexpr uint8_t pinCount = 32;
+
+    struct HostPin {
+        GPIO_TypeDef *GPIOx;
+        uint16_t GPIO_Pin;
+        bool inverted;
+        uint32_t bsrrOn;
+        uint32_t bsrrOff;
+        uint16_t idrOn;
+    };
+
+    /**
+     * @brief The same masks as PinDigital::updateRegisterMasks().
+     */
+    HostPin makePin(GPIO_TypeDef *GPIOx, const uint16_t GPIO_Pin, const bool inverted) {
+        const uint32_t set = GPIO_Pin;
+        const uint32_t reset = static_cast<uint32_t>(GPIO_Pin) << 16u;
+        return {GPIOx, GPIO_Pin, inverted, inverted ? reset : set, inverted ? set : reset,
+                static_cast<uint16_t>(inverted ? 0 : GPIO_Pin)};
+    }
+
+    // Not inlined, like the virtual PinDigital::isOn() and PinDigitalOut::writePin()
+
+    __attribute__((noinline)) bool halIsOn(const HostPin &pin) {
+        return HAL_GPIO_ReadPin(pin.GPIOx, pin.GPIO_Pin) == (pin.inverted ? GPIO_PIN_RESET : GPIO_PIN_SET);
+    }
+
+    __attribute__((noinline)) bool registerIsOn(const HostPin &pin) {
+        return (pin.GPIOx->IDR & pin.GPIO_Pin) == pin.idrOn;
+    }
+
+    __attribute__((noinline)) void halWritePin(const HostPin &pin, const bool on) {
+        HAL_GPIO_WritePin(pin.GPIOx, pin.GPIO_Pin, (on != pin.inverted) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+    }
+
+    __attribute__((noinline)) void registerWritePin(const HostPin &pin, const bool on) {
+        pin.GPIOx->BSRR = on ? pin.bsrrOn : pin.bsrrOff;
+    }
+
+    /**
+     * Take the fastest of a few runs, so a preempted run does not count. The bus accesses are counted in an
+     * extra run.
+     */
+    template<typename Access>
+    void measure(const char *name, const Access &access) {
+        double ns = 0;
+        for (uint8_t run = 0; run < 5; run++) {
+            hostBusReset(false);
+            const auto start = std::chrono::steady_clock::now();
+            for (uint32_t i = 0; i < iterations; i++) access(i);
+            const double runNs = std::chrono::duration<double, std::nano>(
+                                     std::chrono::steady_clock::now() - start).count();
+            if ((run == 0) || (runNs < ns)) ns = runNs;
+        }
+        hostBusReset();
+        for (uint32_t i = 0; i < 1000; i++) access(i);
+        const double countedCalls = 1000.0 * pinCount;
+        std::printf("%-16s %8.2f ns/call %6.2f bus reads/call %6.2f bus writes/call\n", name,
+                    ns / (static_cast<double>(iterations) * pinCount), hostBus.reads / countedCalls,
+                    hostBus.writes / countedCalls);
+    }
+}
+
+int main() {
+    hostGpioInit();
+
+    HostPin pins[pinCount];
+    GPIO_TypeDef *ports[] = {GPIOA, GPIOB};
+    for (uint8_t i = 0; i < pinCount; i++) {
+        pins[i] = makePin(ports[i / 16], static_cast<uint16_t>(1u << (i % 16)), (i % 3) == 0);
+    }
+    GPIOA->IDR.value = 0x5A5A;
+    GPIOB->IDR.value = 0x0FF0;
+
+    // Both paths have to agree on the state of every pin
+    for (const auto &pin: pins) {
+        if (halIsOn(pin) != registerIsOn(pin)) {
+            std::printf("mismatch on pin 0x%04x\n", pin.GPIO_Pin);
+            return 1;
+        }
+    }
+
+    volatile uint32_t sink = 0;
+    measure("HAL isOn()", [&](uint32_t) {
+        uint32_t on = 0;
+        for (const auto &pin: pins) on += halIsOn(pin);
+        sink = sink + on;
+    });
+    measure("register isOn()", [&](uint32_t) {
+        uint32_t on = 0;
+        for (const auto &pin: pins) on += registerIsOn(pin);
+        sink = sink + on;
+    });
+    measure("HAL write", [&](const uint32_t i) {
+        for (const auto &pin: pins) halWritePin(pin, (i & 1u) != 0);
+    });
+    measure("register write", [&](const uint32_t i) {
+        for (const auto &pin: pins) registerWritePin(pin, (i & 1u) != 0);
+    });
+    return 0;
+}
@@ -0,0 +1,80 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Measures loop() of 32 outputs, that stay on, on the host register file of host/main.h.
+ *
+ * "rewrite" is the former PinDigitalOut::loop(), that wrote the pin and read it back on every call. "shadow"
+ * is the current PinDigitalOut, that only writes, if the commanded state differs from the shadow state.
+ * "shadow, refresh" rewrites each pin every 100 ms, as setRefreshInterval() does for EMC hardened devices.
+ * The pins are looped by hand, so the idle handling of PinManager::loopAll() does not hide the cost.
+ */
+
+#include "PinDigitalOut.hpp"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+using namespace Stm32Gpio;
+
+namespace {
+    constexpr uint32_t iterations = 100000;
+    constexpr uint8_t pinCount = 32;
+
+    /**
+     * @brief PinDigitalOut with the loop() of the functionType::ON branch before the shadow state.
+     */
+    class RewritingPinDigitalOut : public PinDigitalOut {
+    public:
+        RewritingPinDigitalOut(GPIO_TypeDef *GPIOx, const uint16_t GPIO_Pin) : PinDigitalOut(GPIOx, GPIO_Pin) {
+        }
+
+        void loop() override {
+            PinDigital::loop();
+            writePin(true);
+            updatePinState();
+        }
+    };
+
+    template<typename PinType>
+    void measure(const char *name, const uint32_t refreshMs) {
+        std::unique_ptr<PinDigitalOut> pins[pinCount];
+        for (uint8_t i = 0; i < pinCount; i++) {
+            pins[i] = std::make_unique<PinType>(i < 16 ? GPIOA : GPIOB, static_cast<uint16_t>(1u << (i % 16)));
+            pins[i]->setup();
+            pins[i]->setRefreshInterval(refreshMs);
+            pins[i]->setOn();
+        }
+
+        double ns = 0;
+        for (uint8_t run = 0; run < 5; run++) {
+            hostBusReset(false);
+            const auto start = std::chrono::steady_clock::now();
+            for (uint32_t i = 0; i < iterations; i++) {
+                hostTickMs++;
+                for (const auto &pin: pins) static_cast<Pin *>(pin.get())->loop();
+            }
+            const double runNs = std::chrono::duration<double, std::nano>(
+                                     std::chrono::steady_clock::now() - start).count();
+            if ((run == 0) || (runNs < ns)) ns = runNs;
+        }
+
+        hostBusReset();
+        for (uint32_t i = 0; i < 1000; i++) {
+            hostTickMs++;
+            for (const auto &pin: pins) static_cast<Pin *>(pin.get())->loop();
+        }
+        std::printf("%-18s %8.1f ns/loop of %u pins %8.2f bus reads/loop %8.2f bus writes/loop\n", name,
+                    ns / iterations, pinCount, hostBus.reads / 1000.0, hostBus.writes / 1000.0);
+    }
+}
+
+int main() {
+    hostGpioInit();
+    measure<RewritingPinDigitalOut>("rewrite", 0);
+    measure<PinDigitalOut>("shadow", 0);
+    measure<PinDigitalOut>("shadow, refresh", 100);
+    return 0;
+}
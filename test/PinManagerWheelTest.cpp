@@ -0,0 +1,137 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Runs PinManager::loopAll() with LIBSMART_STM32GPIO_ENABLE_TIMER_WHEEL on the host register file and checks,
+ * that only the pins on the awake list are looped: sleeping pins are skipped, a blinking pin is looped at its
+ * edges only, a setter wakes up a sleeping pin, and an output, that is woken up by an input, is looped in the
+ * same iteration.
+ */
+
+#include "PinDigitalIn.hpp"
+#include "PinDigitalOut.hpp"
+#include "TestCheck.hpp"
+#include <memory>
+#include <vector>
+
+using namespace Stm32Gpio;
+
+namespace {
+    /**
+     * @brief PinDigitalOut, that records the calls of loop().
+     */
+    class CountingPinDigitalOut : public PinDigitalOut {
+    public:
+        CountingPinDigitalOut(GPIO_TypeDef *GPIOx, const uint16_t GPIO_Pin) : PinDigitalOut(GPIOx, GPIO_Pin) {
+        }
+
+        void loop() override {
+            loops++;
+            lastLoopMs = hostTickMs;
+            PinDigitalOut::loop();
+        }
+
+        uint32_t loops = 0;
+        uint32_t lastLoopMs = 0;
+    };
+
+    void tick() {
+        hostTickMs++;
+        PinManager::loopAll();
+    }
+
+    void testSleepingPins() {
+        std::vector<std::unique_ptr<CountingPinDigitalOut>> pins;
+        for (uint8_t i = 0; i < 32; i++) {
+            pins.push_back(std::make_unique<CountingPinDigitalOut>(i < 16 ? GPIOA : GPIOB,
+                                                                   static_cast<uint16_t>(1u << (i % 16))));
+            pins[i]->setup();
+            pins[i]->setOn();
+        }
+        // Every new pin is looped once and falls asleep
+        tick();
+        for (const auto &pin: pins) CHECK_EQUAL(1, pin->loops);
+        CHECK(pins[0]->isLoopIdle());
+        CHECK_EQUAL(Pin::NO_DEADLINE, PinManager::millisUntilNextDeadline());
+
+        for (uint32_t i = 0; i < 1000; i++) tick();
+        for (const auto &pin: pins) CHECK_EQUAL(1, pin->loops);
+
+        // A setter wakes up the pin, it is looped once more
+        pins[5]->setOff();
+        CHECK(!pins[5]->isLoopIdle());
+        CHECK_EQUAL(0, PinManager::millisUntilNextDeadline());
+        tick();
+        tick();
+        CHECK_EQUAL(2, pins[5]->loops);
+        CHECK_EQUAL(1, pins[6]->loops);
+
+        // An awake pin can be removed
+        pins[7]->setOff();
+        pins[7].reset();
+        pins[8]->setOff();
+        tick();
+        CHECK_EQUAL(2, pins[8]->loops);
+    }
+
+    void testBlink() {
+        CountingPinDigitalOut blinking(GPIOC, GPIO_PIN_0);
+        CountingPinDigitalOut steady(GPIOC, GPIO_PIN_1);
+        blinking.setup();
+        steady.setup();
+        steady.setOn();
+        const uint32_t startMs = hostTickMs;
+        blinking.setBlink(30, 20);
+        tick();
+        const uint32_t firstLoops = blinking.loops;
+
+        // The pin is on for 30 ms and off for 20 ms, so it is looped at the edges only
+        uint32_t edges = 0;
+        for (uint32_t ms = 2; ms <= 500; ms++) {
+            const uint32_t loops = blinking.loops;
+            tick();
+            const uint32_t phaseMs = (hostTickMs - startMs) % 50;
+            const bool edge = (phaseMs == 30) || (phaseMs == 0);
+            if (edge) edges++;
+            CHECK_EQUAL(edge ? loops + 1 : loops, blinking.loops);
+            if (!edge) CHECK(PinManager::millisUntilNextDeadline() != 0);
+        }
+        CHECK_EQUAL(firstLoops + edges, blinking.loops);
+        CHECK_EQUAL(1, steady.loops);
+    }
+
+    void testInputWakesOutput() {
+        CountingPinDigitalOut output(GPIOD, GPIO_PIN_0);
+        PinDigitalIn input(GPIOD, GPIO_PIN_1);
+        output.setup();
+        input.setup();
+        output.setOn();
+        tick();
+        tick();
+
+        static CountingPinDigitalOut *reaction = &output;
+        input.setOnChangeCallback([](PinInterface *) { reaction->setOff(); });
+        const uint32_t loops = output.loops;
+        // The polled input sees the edge and switches the output, that is looped later in the same iteration
+        GPIOD->IDR.value |= GPIO_PIN_1;
+        tick();
+        CHECK_EQUAL(loops + 1, output.loops);
+        CHECK_EQUAL(hostTickMs, output.lastLoopMs);
+        // The polled input stays awake, the output sleeps again
+        CHECK(!input.isLoopIdle());
+        CHECK(output.isLoopIdle());
+        tick();
+        CHECK_EQUAL(loops + 1, output.loops);
+    }
+}
+
+int main() {
+    hostGpioInit();
+    hostBusReset(false);
+    testSleepingPins();
+    testBlink();
+    testInputWakesOutput();
+    return 0;
+}
@@ -0,0 +1,144 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Toggles a polled input on the host register file and checks the onChange subscribers of the pin: the plain
+ * callback is called first and takes no subscription, as long as it is alone, subscribers are called by priority,
+ * unsubscribing during the dispatch is safe, and the plain callback moves back into the pin, when the last
+ * subscriber has left.
+ */
+
+#include "PinDigitalIn.hpp"
+#include "TestCheck.hpp"
+#include <string>
+
+using namespace Stm32Gpio;
+
+namespace {
+    std::string calls;
+    ChangeSubscription *cancelled = nullptr;
+
+    void toggle(PinDigitalIn &pin) {
+        GPIOA->IDR.value ^= pin.getPinMask();
+        hostTickMs++;
+        PinManager::loopAll();
+    }
+
+    void recordPlain(PinInterface *) { calls += 'p'; }
+
+    void recordOther(PinInterface *) { calls += 'o'; }
+
+    void recordContext(void *context, PinInterface *, const PinEvent &) {
+        calls += *static_cast<const char *>(context);
+    }
+
+    void cancelOther(void *context, PinInterface *pin, const PinEvent &) {
+        calls += *static_cast<const char *>(context);
+        static_cast<Pin *>(pin)->unsubscribe(cancelled);
+    }
+
+    void testPlainCallback(PinDigitalIn &pin) {
+        CHECK(pin.setOnChangeCallback(&recordPlain));
+        CHECK_EQUAL(SubscriptionPool::size, SubscriptionPool::getFreeCount());
+        calls.clear();
+        toggle(pin);
+        CHECK(calls == "p");
+    }
+
+    void testSubscribers(PinDigitalIn &pin) {
+        static const char low = 'l', high = 'h', same = 's';
+        // The first subscriber takes a second subscription for the plain callback
+        ChangeSubscription *lowSubscription = pin.subscribe(&recordContext, const_cast<char *>(&low), 1);
+        CHECK(lowSubscription != nullptr);
+        CHECK_EQUAL(SubscriptionPool::size - 2, SubscriptionPool::getFreeCount());
+        ChangeSubscription *highSubscription = pin.subscribe(&recordContext, const_cast<char *>(&high), UINT8_MAX);
+        ChangeSubscription *sameSubscription = pin.subscribe(&recordContext, const_cast<char *>(&same), 1);
+        calls.clear();
+        toggle(pin);
+        CHECK(calls == "phls");
+
+        // Replacing the plain callback keeps its place
+        CHECK(pin.setOnChangeCallback(&recordOther));
+        CHECK_EQUAL(SubscriptionPool::size - 4, SubscriptionPool::getFreeCount());
+        calls.clear();
+        toggle(pin);
+        CHECK(calls == "ohls");
+
+        CHECK(pin.unsubscribe(highSubscription));
+        CHECK(pin.unsubscribe(sameSubscription));
+        CHECK(!pin.unsubscribe(sameSubscription));
+        CHECK_EQUAL(SubscriptionPool::size - 2, SubscriptionPool::getFreeCount());
+
+        // The plain callback moves back into the pin with the last subscriber
+        CHECK(pin.unsubscribe(lowSubscription));
+        CHECK_EQUAL(SubscriptionPool::size, SubscriptionPool::getFreeCount());
+        calls.clear();
+        toggle(pin);
+        CHECK(calls == "o");
+    }
+
+    void testUnsubscribeDuringDispatch(PinDigitalIn &pin) {
+        static const char first = 'f', second = 's';
+        pin.subscribe(&cancelOther, const_cast<char *>(&first), 2);
+        cancelled = pin.subscribe(&recordContext, const_cast<char *>(&second), 1);
+        calls.clear();
+        toggle(pin);
+        CHECK(calls == "of");
+        CHECK_EQUAL(SubscriptionPool::size - 2, SubscriptionPool::getFreeCount());
+        calls.clear();
+        toggle(pin);
+        CHECK(calls == "of");
+
+        // Only the plain callback is kept
+        CHECK(pin.setOnChangeCallback(nullptr, nullptr));
+        CHECK_EQUAL(SubscriptionPool::size, SubscriptionPool::getFreeCount());
+        CHECK(pin.setOnChangeCallback(nullptr));
+        calls.clear();
+        toggle(pin);
+        CHECK(calls.empty());
+    }
+
+    void testExhaustedPool(PinDigitalIn &pin) {
+        static const char context = 'c';
+        ChangeSubscription *subscriptions[SubscriptionPool::size] = {};
+        for (auto &subscription: subscriptions) {
+            subscription = pin.subscribe(&recordContext, const_cast<char *>(&context));
+            CHECK(subscription != nullptr);
+        }
+        // A plain callback is kept in a subscription, while the pin has subscribers
+        CHECK(!pin.setOnChangeCallback(&recordPlain));
+        CHECK(pin.unsubscribe(subscriptions[0]));
+        CHECK(pin.setOnChangeCallback(&recordPlain));
+        for (uint16_t i = 1; i < SubscriptionPool::size; i++) CHECK(pin.unsubscribe(subscriptions[i]));
+        CHECK_EQUAL(SubscriptionPool::size, SubscriptionPool::getFreeCount());
+
+        // Leaving the pin, the plain callback needs a subscription of its own
+        for (uint16_t i = 1; i < SubscriptionPool::size; i++) {
+            CHECK(pin.subscribe(&recordContext, const_cast<char *>(&context)) != nullptr);
+        }
+        CHECK(pin.subscribe(&recordContext, const_cast<char *>(&context)) == nullptr);
+        calls.clear();
+        toggle(pin);
+        CHECK(calls == "pccccccc");
+        CHECK(pin.setOnChangeCallback(nullptr, nullptr));
+    }
+}
+
+int main() {
+    hostGpioInit();
+    hostBusReset(false);
+    {
+        PinDigitalIn pin(GPIOA, GPIO_PIN_3);
+        pin.setup();
+        toggle(pin);
+        testPlainCallback(pin);
+        testSubscribers(pin);
+        testUnsubscribeDuringDispatch(pin);
+        testExhaustedPool(pin);
+    }
+    // The pin has returned its subscriptions
+    CHECK_EQUAL(SubscriptionPool::size, SubscriptionPool::getFreeCount());
+    return 0;
+}
@@ -0,0 +1,78 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Measures the bus accesses and the time per loop tick for 30 inputs on GPIOA, GPIOB and GPIOC on the host
+ * register file of host/main.h.
+ *
+ * "HAL" reads every pin by HAL_GPIO_ReadPin(), "register" reads IDR once per pin, as PinDigital::isOn() does
+ * with LIBSMART_STM32GPIO_ENABLE_REGISTER_ACCESS, and "snapshot" serves the pins from PortSnapshot, as
+ * PinDigitalIn::isOn() does with LIBSMART_STM32GPIO_ENABLE_PORT_SNAPSHOT. Each pin is read once per tick, as
+ * PinDigital::updatePinState() does.
+ *
+ * On the host, the register file is cached memory, so the time of "snapshot" shows the cost of the
+ * bookkeeping only. On the target, every read of IDR is a transfer on the APB bridge, that takes several
+ * cycles and can not be cached, which is what the snapshot saves.
+ */
+
+#include "PortSnapshot.hpp"
+#include <chrono>
+#include <cstdio>
+
+using namespace Stm32Gpio;
+
+namespace {
+    constexpr uint32_t ticks = 200000;
+    constexpr uint8_t pinCount = 30;
+
+    struct HostPin {
+        GPIO_TypeDef *GPIOx;
+        uint16_t GPIO_Pin;
+    };
+
+    template<typename Tick>
+    void measure(const char *name, const Tick &tick) {
+        double ns = 0;
+        for (uint8_t run = 0; run < 5; run++) {
+            hostBusReset(false);
+            const auto start = std::chrono::steady_clock::now();
+            for (uint32_t i = 0; i < ticks; i++) tick();
+            const double runNs = std::chrono::duration<double, std::nano>(
+                                     std::chrono::steady_clock::now() - start).count();
+            if ((run == 0) || (runNs < ns)) ns = runNs;
+        }
+        hostBusReset();
+        for (uint32_t i = 0; i < 1000; i++) tick();
+        std::printf("%-10s %8.1f ns/tick %6.1f bus reads/tick\n", name, ns / ticks, hostBus.reads / 1000.0);
+    }
+}
+
+int main() {
+    hostGpioInit();
+
+    HostPin pins[pinCount];
+    GPIO_TypeDef *ports[] = {GPIOA, GPIOB, GPIOC};
+    for (uint8_t i = 0; i < pinCount; i++) pins[i] = {ports[i % 3], static_cast<uint16_t>(1u << (i / 3))};
+
+    volatile uint32_t sink = 0;
+    measure("HAL", [&] {
+        uint32_t on = 0;
+        for (const auto &pin: pins) on += HAL_GPIO_ReadPin(pin.GPIOx, pin.GPIO_Pin) == GPIO_PIN_SET;
+        sink = sink + on;
+    });
+    measure("register", [&] {
+        uint32_t on = 0;
+        for (const auto &pin: pins) on += (pin.GPIOx->IDR & pin.GPIO_Pin) != 0;
+        sink = sink + on;
+    });
+    measure("snapshot", [&] {
+        PortSnapshot::nextTick();
+        uint32_t on = 0;
+        for (const auto &pin: pins) on += (PortSnapshot::read(pin.GPIOx) & pin.GPIO_Pin) != 0;
+        PortSnapshot::endTick();
+        sink = sink + on;
+    });
+    return 0;
+}
@@ -0,0 +1,66 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Checks PortSnapshot on the host register file: within a tick, each port is read once and all reads see
+ * the latched word, outside of a tick every read goes to the register.
+ */
+
+#include "PortSnapshot.hpp"
+#include "TestCheck.hpp"
+
+using namespace Stm32Gpio;
+
+namespace {
+    void testOutsideTick() {
+        // Pins, that are looped by hand, never see a stale value
+        GPIOA->IDR.value = 0x0001;
+        hostBusReset();
+        CHECK_EQUAL(0x0001, PortSnapshot::read(GPIOA));
+        GPIOA->IDR.value = 0x0002;
+        CHECK_EQUAL(0x0002, PortSnapshot::read(GPIOA));
+        CHECK_EQUAL(2, hostBus.reads);
+    }
+
+    void testWithinTick() {
+        GPIOA->IDR.value = 0x00F0;
+        GPIOB->IDR.value = 0x0F00;
+        hostBusReset();
+        PortSnapshot::nextTick();
+        for (uint8_t i = 0; i < 10; i++) {
+            CHECK_EQUAL(0x00F0, PortSnapshot::read(GPIOA));
+            CHECK_EQUAL(0x0F00, PortSnapshot::read(GPIOB));
+            // A change within the tick is seen in the next tick only, so all pins of a port agree
+            GPIOA->IDR.value = 0x000F;
+        }
+        CHECK_EQUAL(2, hostBus.reads);
+
+        PortSnapshot::nextTick();
+        CHECK_EQUAL(0x000F, PortSnapshot::read(GPIOA));
+        CHECK_EQUAL(3, hostBus.reads);
+
+        PortSnapshot::endTick();
+        GPIOA->IDR.value = 0x1234;
+        CHECK_EQUAL(0x1234, PortSnapshot::read(GPIOA));
+        CHECK_EQUAL(4, hostBus.reads);
+    }
+
+    void testUpperHalfIgnored() {
+        // The reserved upper half of IDR is not part of the port state
+        GPIOC->IDR.value = 0xFFFF8001;
+        PortSnapshot::nextTick();
+        CHECK_EQUAL(0x8001, PortSnapshot::read(GPIOC));
+        PortSnapshot::endTick();
+        CHECK_EQUAL(0x8001, PortSnapshot::read(GPIOC));
+    }
+}
+
+int main() {
+    hostGpioInit();
+    testOutsideTick();
+    testWithinTick();
+    testUpperHalfIgnored();
+    return 0;
+}
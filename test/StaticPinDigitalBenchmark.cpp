@@ -0,0 +1,103 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Compares the cost of loop() of the compile time pins StaticPinDigitalIn and StaticPinDigitalOut with the
+ * virtual PinDigitalIn and PinDigitalOut on the host register file of host/main.h. Each side has 16 inputs
+ * on GPIOA and 16 outputs on GPIOB, that are looped by hand, as an application without PinManager does.
+ * The inputs toggle every few loops, so the change handling runs, too.
+ */
+
+#include "PinDigitalIn.hpp"
+#include "PinDigitalOut.hpp"
+#include "StaticPinDigital.hpp"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+using namespace Stm32Gpio;
+
+namespace {
+    constexpr uint32_t iterations = 200000;
+    constexpr uint8_t pinCount = 16;
+    uint32_t changes = 0;
+
+    template<size_t... I>
+    auto makeStaticInputs(std::index_sequence<I...>) {
+        return std::tuple<StaticPinDigitalIn<GPIOA_BASE, I>...>{};
+    }
+
+    template<size_t... I>
+    auto makeStaticOutputs(std::index_sequence<I...>) {
+        return std::tuple<StaticPinDigitalOut<GPIOB_BASE, I>...>{};
+    }
+
+    void stimulate(const uint32_t i) {
+        GPIOA->IDR.value = (i & 4u) != 0 ? 0xFFFF : 0x0000;
+        hostTickMs = i;
+    }
+
+    template<typename Loop>
+    void measure(const char *name, const Loop &loop) {
+        double ns = 0;
+        for (uint8_t run = 0; run < 5; run++) {
+            hostBusReset(false);
+            changes = 0;
+            const auto start = std::chrono::steady_clock::now();
+            for (uint32_t i = 0; i < iterations; i++) {
+                stimulate(i);
+                loop();
+            }
+            const double runNs = std::chrono::duration<double, std::nano>(
+                                     std::chrono::steady_clock::now() - start).count();
+            if ((run == 0) || (runNs < ns)) ns = runNs;
+        }
+        const uint32_t runChanges = changes;
+
+        hostBusReset();
+        for (uint32_t i = 0; i < 1000; i++) {
+            stimulate(i);
+            loop();
+        }
+        const double loops = 2.0 * pinCount;
+        std::printf("%-24s %8.2f ns/loop() %6.2f bus reads/loop() %6.2f bus writes/loop() %8u changes\n", name,
+                    ns / (iterations * loops), hostBus.reads / (1000 * loops), hostBus.writes / (1000 * loops),
+                    runChanges);
+    }
+}
+
+int main() {
+    hostGpioInit();
+
+    auto staticInputs = makeStaticInputs(std::make_index_sequence<pinCount>{});
+    auto staticOutputs = makeStaticOutputs(std::make_index_sequence<pinCount>{});
+    std::apply([](auto &... pin) {
+        (pin.setOnChangeCallback([](auto *) { changes++; }), ...);
+    }, staticInputs);
+    std::apply([](auto &... pin) { (pin.setOn(), ...); }, staticOutputs);
+
+    std::unique_ptr<PinDigitalIn> inputs[pinCount];
+    std::unique_ptr<PinDigitalOut> outputs[pinCount];
+    for (uint8_t i = 0; i < pinCount; i++) {
+        inputs[i] = std::make_unique<PinDigitalIn>(GPIOA, static_cast<uint16_t>(1u << i));
+        inputs[i]->setup();
+        inputs[i]->setOnChangeCallback([](PinInterface *) { changes++; });
+        outputs[i] = std::make_unique<PinDigitalOut>(GPIOB, static_cast<uint16_t>(1u << i));
+        outputs[i]->setup();
+        outputs[i]->setOn();
+    }
+
+    measure("StaticPinDigital", [&] {
+        std::apply([](auto &... pin) { (pin.loop(), ...); }, staticInputs);
+        std::apply([](auto &... pin) { (pin.loop(), ...); }, staticOutputs);
+    });
+    measure("PinDigitalIn/Out", [&] {
+        for (const auto &pin: inputs) static_cast<Pin *>(pin.get())->loop();
+        for (const auto &pin: outputs) static_cast<Pin *>(pin.get())->loop();
+    });
+    return 0;
+}
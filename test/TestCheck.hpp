@@ -0,0 +1,37 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef LIBSMART_STM32GPIO_TESTCHECK_HPP
+#define LIBSMART_STM32GPIO_TESTCHECK_HPP
+
+#include <cstdio>
+#include <cstdlib>
+
+/**
+ * Abort the test with the failed condition and its location.
+ */
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            std::exit(1); \
+        } \
+    } while (0)
+
+/**
+ * Abort the test, if two integral values differ, and print both.
+ */
+#define CHECK_EQUAL(expected, actual) \
+    do { \
+        const long long expectedValue = static_cast<long long>(expected); \
+        const long long actualValue = static_cast<long long>(actual); \
+        if (expectedValue != actualValue) { \
+            std::fprintf(stderr, "%s:%d: CHECK_EQUAL(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, \
+                         #expected, #actual, expectedValue, actualValue); \
+            std::exit(1); \
+        } \
+    } while (0)
+
+#endif //LIBSMART_STM32GPIO_TESTCHECK_HPP
@@ -0,0 +1,98 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Measures the cost of one PinManager::loopAll() tick for 10 to 10000 blinking outputs.
+ *
+ * Ten outputs blink fast (every 10 to 100 ms), the others blink slowly (every 20 to 30 s), so they sleep for
+ * the whole run. The benchmark is built twice from this file: TimerWheelBenchmark with
+ * LIBSMART_STM32GPIO_ENABLE_TIMER_WHEEL, where loopAll() visits the pins on the awake list only, and
+ * TimerWheelPolledBenchmark without it, where every blinking pin is looped on every tick and checks its blink
+ * deadline itself.
+ */
+
+#include "PinDigitalOut.hpp"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace Stm32Gpio;
+
+namespace {
+    constexpr uint32_t ticks = 2000;
+    constexpr uint32_t fastPins = 10;
+
+#ifdef LIBSMART_STM32GPIO_ENABLE_TIMER_WHEEL
+    constexpr const char *variant = "timer wheel";
+#else
+    constexpr const char *variant = "polled";
+#endif
+
+    uint32_t loops = 0;
+
+    /**
+     * @brief PinDigitalOut, that counts the calls of loop().
+     */
+    class CountingPinDigitalOut : public PinDigitalOut {
+    public:
+        CountingPinDigitalOut(GPIO_TypeDef *GPIOx, const uint16_t GPIO_Pin) : PinDigitalOut(GPIOx, GPIO_Pin) {
+        }
+
+        void loop() override {
+            loops++;
+            PinDigitalOut::loop();
+        }
+    };
+
+    std::vector<std::unique_ptr<PinDigitalOut>> makePins(const uint32_t count) {
+        GPIO_TypeDef *const ports[] = {GPIOA, GPIOB, GPIOC, GPIOD, GPIOE};
+        std::mt19937 random(count);
+        std::vector<std::unique_ptr<PinDigitalOut>> pins;
+        pins.reserve(count);
+        for (uint32_t i = 0; i < count; i++) {
+            pins.push_back(std::make_unique<CountingPinDigitalOut>(ports[(i / 16) % 5],
+                                                                   static_cast<uint16_t>(1u << (i % 16))));
+            pins[i]->setup();
+            pins[i]->setBlink(i < fastPins ? 10 + random() % 91 : 20000 + random() % 10001);
+        }
+        return pins;
+    }
+
+    double measure(const uint32_t count, double &loopsPerTick) {
+        const auto pins = makePins(count);
+        // The first loop of the new pins is not measured
+        hostTickMs++;
+        PinManager::loopAll();
+
+        double ns = 0;
+        loops = 0;
+        for (uint8_t run = 0; run < 5; run++) {
+            const auto start = std::chrono::steady_clock::now();
+            for (uint32_t tick = 0; tick < ticks; tick++) {
+                hostTickMs++;
+                PinManager::loopAll();
+            }
+            const double runNs = std::chrono::duration<double, std::nano>(
+                                     std::chrono::steady_clock::now() - start).count();
+            if ((run == 0) || (runNs < ns)) ns = runNs;
+        }
+        loopsPerTick = loops / (5.0 * ticks);
+        return ns / ticks;
+    }
+}
+
+int main() {
+    hostGpioInit();
+    hostBusReset(false);
+    std::printf("%s\n%8s %12s %16s\n", variant, "pins", "ns/tick", "pin loops/tick");
+    for (const uint32_t count: {10u, 100u, 1000u, 10000u}) {
+        double loopsPerTick = 0;
+        const double ns = measure(count, loopsPerTick);
+        std::printf("%8u %12.1f %16.2f\n", count, ns, loopsPerTick);
+    }
+    return 0;
+}
@@ -0,0 +1,162 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Drives TimerWheel with a virtual millisecond clock and checks, that the callback of every timer is called
+ * exactly at its deadline, also across the cascades of the higher levels and the wrap of millis(), and that
+ * millisUntilNextExpiry() reports the earliest deadline.
+ */
+
+#include "TimerWheel.hpp"
+#include "TestCheck.hpp"
+#include <random>
+#include <vector>
+
+using namespace Stm32Gpio;
+
+namespace {
+    struct TestTimer {
+        TestTimer() : node(&TestTimer::expire, this) {
+        }
+
+        static void expire(void *context) { static_cast<TestTimer *>(context)->idle = false; }
+
+        bool idle = true;
+        TimerNode node;
+        uint32_t deadlineMs = 0;
+    };
+
+    /**
+     * Advance the wheel millisecond by millisecond and check each timer at every step.
+     */
+    void runUntil(std::vector<TestTimer> &timers, uint32_t &nowMs, const uint32_t endMs) {
+        while (nowMs != endMs) {
+            nowMs++;
+            TimerWheel::advance(nowMs);
+            for (auto &timer: timers) {
+                const bool due = static_cast<int32_t>(nowMs - timer.deadlineMs) >= 0;
+                CHECK_EQUAL(!due, timer.idle);
+                CHECK_EQUAL(!due, timer.node.isScheduled());
+            }
+        }
+    }
+
+    void testDeadlines(const uint32_t startMs) {
+        uint32_t nowMs = startMs;
+        TimerWheel::advance(nowMs);
+
+        std::mt19937 random(startMs);
+        std::vector<TestTimer> timers(300);
+        for (auto &timer: timers) {
+            timer.deadlineMs = nowMs + 1 + random() % (TimerWheel::MAX_DELAY_MS - 1);
+            TimerWheel::schedule(timer.node, timer.deadlineMs);
+        }
+        runUntil(timers, nowMs, nowMs + TimerWheel::MAX_DELAY_MS);
+    }
+
+    void testJumps() {
+        // loopAll() may run late, then several milliseconds are processed at once
+        uint32_t nowMs = 5000;
+        TimerWheel::advance(nowMs);
+        std::vector<TestTimer> timers(64);
+        for (uint32_t i = 0; i < timers.size(); i++) {
+            timers[i].deadlineMs = nowMs + 1 + i * 97;
+            TimerWheel::schedule(timers[i].node, timers[i].deadlineMs);
+        }
+        while (nowMs < 5000 + 64 * 97) {
+            nowMs += 13;
+            TimerWheel::advance(nowMs);
+            for (auto &timer: timers) CHECK_EQUAL(static_cast<int32_t>(nowMs - timer.deadlineMs) < 0, timer.idle);
+        }
+    }
+
+    void testCancelAndReschedule() {
+        uint32_t nowMs = 100;
+        TimerWheel::advance(nowMs);
+        std::vector<TestTimer> timers(2);
+        TestTimer cancelled;
+
+        timers[0].deadlineMs = 150;
+        TimerWheel::schedule(timers[0].node, 150);
+        TimerWheel::schedule(cancelled.node, 120);
+        TimerWheel::cancel(cancelled.node);
+        CHECK(!cancelled.node.isScheduled());
+        // Rescheduling moves the timer
+        TimerWheel::schedule(timers[1].node, 2000);
+        TimerWheel::schedule(timers[1].node, 130);
+        timers[1].deadlineMs = 130;
+
+        runUntil(timers, nowMs, 200);
+        // The cancelled timer never fires
+        CHECK(cancelled.idle);
+    }
+
+    void testOutOfRange() {
+        uint32_t nowMs = 7;
+        TimerWheel::advance(nowMs);
+        std::vector<TestTimer> timers(2);
+
+        // A deadline in the past expires on the next tick
+        timers[0].deadlineMs = nowMs + 1;
+        TimerWheel::schedule(timers[0].node, nowMs - 5);
+        // A deadline beyond the range wakes the owner early, at the end of the range
+        timers[1].deadlineMs = nowMs + TimerWheel::MAX_DELAY_MS;
+        TimerWheel::schedule(timers[1].node, nowMs + 10 * TimerWheel::MAX_DELAY_MS);
+        runUntil(timers, nowMs, nowMs + TimerWheel::MAX_DELAY_MS + 5);
+    }
+
+    uint32_t bruteForceNextExpiry(const std::vector<TestTimer> &timers, const uint32_t nowMs) {
+        uint32_t nextMs = TimerWheel::NO_EXPIRY;
+        for (const auto &timer: timers) {
+            if (!timer.node.isScheduled()) continue;
+            // The wheel stores the clamped deadline of far timers in the node
+            const uint32_t remainingMs = timer.node.expiresMs - nowMs;
+            if (remainingMs < nextMs) nextMs = remainingMs;
+        }
+        return nextMs;
+    }
+
+    void testNextExpiry(const uint32_t startMs) {
+        uint32_t nowMs = startMs;
+        TimerWheel::advance(nowMs);
+        CHECK_EQUAL(TimerWheel::NO_EXPIRY, TimerWheel::millisUntilNextExpiry(nowMs));
+
+        std::mt19937 random(startMs + 1);
+        std::vector<TestTimer> timers(40);
+        for (uint32_t step = 0; step < 200000; step++) {
+            // Like a pin at the end of its loop(): schedule the next deadline, or sleep without one
+            TestTimer &timer = timers[random() % timers.size()];
+            const uint32_t choice = random() % 16;
+            if (choice == 0) {
+                TimerWheel::cancel(timer.node);
+            } else if (!timer.node.isScheduled() || (choice < 4)) {
+                const uint32_t range = choice < 12 ? 64 : 2 * TimerWheel::MAX_DELAY_MS;
+                TimerWheel::schedule(timer.node, nowMs + 1 + random() % range);
+            }
+
+            // Like loopAll(): sleep until the reported expiry, sometimes shorter
+            const uint32_t nextMs = TimerWheel::millisUntilNextExpiry(nowMs);
+            CHECK_EQUAL(bruteForceNextExpiry(timers, nowMs), nextMs);
+            if (nextMs == TimerWheel::NO_EXPIRY) continue;
+            nowMs += random() % 4 == 0 ? random() % (nextMs + 1) : nextMs;
+            TimerWheel::advance(nowMs);
+            CHECK(TimerWheel::millisUntilNextExpiry(nowMs) != 0);
+        }
+        for (auto &timer: timers) TimerWheel::cancel(timer.node);
+    }
+}
+
+int main() {
+    testDeadlines(0);
+    testDeadlines(123456);
+    // millis() wraps during the run
+    testDeadlines(UINT32_MAX - 10000);
+    testJumps();
+    testCancelAndReschedule();
+    testOutOfRange();
+    testNextExpiry(0);
+    testNextExpiry(UINT32_MAX - 1000000);
+    return 0;
+}
@@ -0,0 +1,64 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Compares the cost of debouncing a 16-bit port with VerticalCounter to a counter per pin, as the
+ * time based debounce of PinDigitalIn does it.
+ */
+
+#include "VerticalCounter.hpp"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Stm32Gpio;
+
+namespace {
+    constexpr uint32_t sampleCount = 1u << 20;
+
+    template<typename Fn>
+    void measure(const char *name, const std::vector<uint16_t> &samples, Fn &&debounce) {
+        const auto start = std::chrono::steady_clock::now();
+        uint32_t checksum = 0;
+        for (const uint16_t sample: samples) checksum += debounce(sample);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        const double ns = std::chrono::duration<double, std::nano>(elapsed).count();
+        std::printf("%-24s %8.2f ns/port %8.3f ns/pin (checksum %u)\n", name, ns / samples.size(),
+                    ns / samples.size() / 16, checksum);
+    }
+}
+
+int main() {
+    std::mt19937 random(1);
+    std::vector<uint16_t> samples(sampleCount);
+    uint16_t level = 0;
+    for (auto &sample: samples) {
+        if (random() % 32 == 0) level ^= static_cast<uint16_t>(random());
+        sample = level ^ (random() % 4 == 0 ? static_cast<uint16_t>(random()) : 0);
+    }
+
+    VerticalCounter<2> counter2;
+    measure("VerticalCounter<2>", samples, [&](const uint16_t sample) { return counter2.sample(sample); });
+
+    VerticalCounter<3> counter3;
+    measure("VerticalCounter<3>", samples, [&](const uint16_t sample) { return counter3.sample(sample); });
+
+    uint16_t state = 0;
+    uint8_t counts[16] = {};
+    measure("counter per pin", samples, [&](const uint16_t sample) {
+        for (uint8_t i = 0; i < 16; i++) {
+            const uint16_t bit = 1u << i;
+            if (((state ^ sample) & bit) == 0) {
+                counts[i] = 0;
+            } else if (++counts[i] == 4) {
+                state ^= bit;
+                counts[i] = 0;
+            }
+        }
+        return state;
+    });
+    return 0;
+}
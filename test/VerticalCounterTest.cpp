@@ -0,0 +1,125 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Feeds bouncy traces into VerticalCounter and compares every step with a plain per-input counter:
+ * the debounced state of an input toggles after 2^Bits consecutive samples, that differ from it.
+ */
+
+#include "VerticalCounter.hpp"
+#include "TestCheck.hpp"
+#include <random>
+
+using namespace Stm32Gpio;
+
+namespace {
+    template<uint8_t Bits>
+    class ReferenceDebounce {
+    public:
+        void reset(const uint16_t newState) {
+            state = newState;
+            for (auto &count: counts) count = 0;
+        }
+
+        uint16_t sample(const uint16_t sample) {
+            for (uint8_t i = 0; i < 16; i++) {
+                const uint16_t bit = 1u << i;
+                if (((state ^ sample) & bit) == 0) {
+                    counts[i] = 0;
+                } else if (++counts[i] == (1u << Bits)) {
+                    state ^= bit;
+                    counts[i] = 0;
+                }
+            }
+            return state;
+        }
+
+    private:
+        uint16_t state = 0;
+        uint8_t counts[16] = {};
+    };
+
+    /**
+     * Every input switches its level now and then. Around each switch it bounces for a few samples.
+     */
+    class BouncyTrace {
+    public:
+        explicit BouncyTrace(const uint32_t seed) : random(seed) {
+        }
+
+        uint16_t next() {
+            uint16_t sample = 0;
+            for (uint8_t i = 0; i < 16; i++) {
+                if (bounceLeft[i] == 0 && random() % 64 == 0) {
+                    level[i] = !level[i];
+                    bounceLeft[i] = random() % 12;
+                }
+                bool bit = level[i];
+                if (bounceLeft[i] != 0) {
+                    bounceLeft[i]--;
+                    bit = random() % 2 != 0;
+                }
+                if (bit) sample |= 1u << i;
+            }
+            return sample;
+        }
+
+    private:
+        std::mt19937 random;
+        bool level[16] = {};
+        uint8_t bounceLeft[16] = {};
+    };
+
+    template<uint8_t Bits>
+    void testAgainstReference(const uint32_t seed) {
+        VerticalCounter<Bits> counter;
+        ReferenceDebounce<Bits> reference;
+        BouncyTrace trace(seed);
+        counter.reset(0);
+        reference.reset(0);
+
+        uint32_t toggles = 0;
+        uint16_t previous = 0;
+        for (uint32_t i = 0; i < 200000; i++) {
+            const uint16_t sample = trace.next();
+            const uint16_t state = counter.sample(sample);
+            CHECK_EQUAL(reference.sample(sample), state);
+            CHECK_EQUAL(state, counter.getState());
+            toggles += __builtin_popcount(state ^ previous);
+            previous = state;
+        }
+        // The trace has to exercise the counters at all
+        CHECK(toggles > 1000);
+    }
+
+    template<uint8_t Bits>
+    void testThreshold() {
+        constexpr uint8_t threshold = 1u << Bits;
+        VerticalCounter<Bits> counter;
+        counter.reset(0x0000);
+
+        // One sample short of the threshold, then a glitch back: the state must not change
+        for (uint8_t i = 0; i < threshold - 1; i++) CHECK_EQUAL(0x0000, counter.sample(0x00FF));
+        CHECK_EQUAL(0x0000, counter.sample(0x0000));
+
+        // The counter restarted, so the full number of samples is needed again
+        for (uint8_t i = 0; i < threshold - 1; i++) CHECK_EQUAL(0x0000, counter.sample(0x00FF));
+        CHECK_EQUAL(0x00FF, counter.sample(0x00FF));
+
+        // Inputs, that did not change, keep their state while others toggle
+        for (uint8_t i = 0; i < threshold - 1; i++) CHECK_EQUAL(0x00FF, counter.sample(0xFF0F));
+        CHECK_EQUAL(0xFF0F, counter.sample(0xFF0F));
+    }
+}
+
+int main() {
+    testThreshold<2>();
+    testThreshold<3>();
+    for (uint32_t seed = 1; seed <= 3; seed++) {
+        testAgainstReference<2>(seed);
+        testAgainstReference<3>(seed);
+    }
+    return 0;
+}
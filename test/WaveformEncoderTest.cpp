@@ -0,0 +1,93 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Composes waveforms with WaveformEncoder and plays the BSRR words on a simulated output data register,
+ * the way the DMA of PortWaveform does it.
+ */
+
+#include "WaveformEncoder.hpp"
+#include "TestCheck.hpp"
+
+using namespace Stm32Gpio;
+
+namespace {
+    struct TestPin {
+        uint32_t bsrrOn;
+        uint32_t bsrrOff;
+    };
+
+    TestPin makePin(const uint8_t bit, const bool inverted) {
+        const uint32_t set = 1u << bit;
+        const uint32_t reset = 1u << (bit + 16);
+        return inverted ? TestPin{reset, set} : TestPin{set, reset};
+    }
+
+    /**
+     * Apply a BSRR word to an output data register. The set half wins, like on the hardware.
+     */
+    uint16_t applyBsrr(const uint16_t odr, const uint32_t bsrr) {
+        return static_cast<uint16_t>((odr & ~(bsrr >> 16)) | (bsrr & 0xFFFFu));
+    }
+
+    void testAddEdges() {
+        constexpr uint16_t length = 10;
+        uint32_t buffer[length];
+        WaveformEncoder::clear(buffer, length);
+
+        const TestPin clock = makePin(0, false);
+        const TestPin data = makePin(5, true);
+        const uint16_t clockEdges[] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+        const uint16_t dataEdges[] = {2, 6};
+        CHECK(WaveformEncoder::addEdges(buffer, length, clock.bsrrOn, clock.bsrrOff, false, clockEdges, 9));
+        CHECK(WaveformEncoder::addEdges(buffer, length, data.bsrrOn, data.bsrrOff, true, dataEdges, 2));
+
+        // The clock toggles on every step, the inverted data pin is "on" (low) outside of steps 2 .. 5
+        uint16_t odr = 0xFFFF;
+        for (uint16_t step = 0; step < length; step++) {
+            odr = applyBsrr(odr, buffer[step]);
+            CHECK_EQUAL(step % 2, odr & 1u);
+            const bool dataOn = (step < 2) || (step >= 6);
+            CHECK_EQUAL(dataOn ? 0 : 1, (odr >> 5) & 1u);
+            // Other pins are never touched
+            CHECK_EQUAL(0xFFDE, odr & 0xFFDE);
+        }
+    }
+
+    void testSetLevelOverridesOppositeBit() {
+        uint32_t buffer[2];
+        WaveformEncoder::clear(buffer, 2);
+        const TestPin pin = makePin(3, false);
+
+        CHECK(WaveformEncoder::setLevel(buffer, 2, pin.bsrrOn, pin.bsrrOff, 1, true));
+        CHECK_EQUAL(pin.bsrrOn, buffer[1]);
+        // Without clearing the set bit, the pin would stay "on"
+        CHECK(WaveformEncoder::setLevel(buffer, 2, pin.bsrrOn, pin.bsrrOff, 1, false));
+        CHECK_EQUAL(pin.bsrrOff, buffer[1]);
+        CHECK_EQUAL(0, applyBsrr(0xFFFF, buffer[1]) & (1u << 3));
+        CHECK_EQUAL(0, buffer[0]);
+    }
+
+    void testInvalidEdges() {
+        uint32_t buffer[4] = {1, 2, 3, 4};
+        const TestPin pin = makePin(1, false);
+        const uint16_t outOfRange[] = {1, 4};
+        const uint16_t notAscending[] = {2, 2};
+
+        CHECK(!WaveformEncoder::setLevel(buffer, 4, pin.bsrrOn, pin.bsrrOff, 4, true));
+        CHECK(!WaveformEncoder::addEdges(buffer, 4, pin.bsrrOn, pin.bsrrOff, true, outOfRange, 2));
+        CHECK(!WaveformEncoder::addEdges(buffer, 4, pin.bsrrOn, pin.bsrrOff, true, notAscending, 2));
+        CHECK(!WaveformEncoder::addEdges(buffer, 0, pin.bsrrOn, pin.bsrrOff, true, nullptr, 0));
+        // The buffer is not changed by rejected calls
+        for (uint16_t i = 0; i < 4; i++) CHECK_EQUAL(i + 1, buffer[i]);
+    }
+}
+
+int main() {
+    testAddEdges();
+    testSetLevelOverridesOppositeBit();
+    testInvalidEdges();
+    return 0;
+}
@@ -0,0 +1,17 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Host stand-in for the Helper.hpp of libsmart, that provides millis().
+ */
+
+#ifndef LIBSMART_STM32GPIO_HOST_HELPER_HPP
+#define LIBSMART_STM32GPIO_HOST_HELPER_HPP
+
+#include <main.h>
+
+inline uint32_t millis() { return HAL_GetTick(); }
+
+#endif //LIBSMART_STM32GPIO_HOST_HELPER_HPP
@@ -0,0 +1,158 @@
+/*
+ * SPDX-FileCopyrightText: 2024 Roland Rusch, easy-smart solution GmbH <roland.rusch@easy-smart.ch>
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * Host stand-in for the main.h of a CubeMX project, so the pin classes can be built and measured on Linux.
+ *
+ * The GPIO ports are a register file, that is mapped at the addresses of an STM32F1 (GPIOA_BASE = 0x40010800),
+ * so StaticPinDigital can take the port base as template argument, as it does on the target. Each register
+ * counts the reads and writes, that reach it, which stands in for the accesses to the peripheral bus.
+ * HAL_GPIO_ReadPin() and HAL_GPIO_WritePin() follow the HAL of the F1 family and are not inlined, like the
+ * functions of the HAL library. HAL_GPIO_WritePin() also updates ODR and IDR without counting, as the port does,
+ * so an output reads back the level, that was written. Call hostGpioInit() before the first pin is set up.
+ */
+
+#ifndef LIBSMART_STM32GPIO_HOST_MAIN_H
+#define LIBSMART_STM32GPIO_HOST_MAIN_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/mman.h>
+
+/**
+ * Number of accesses to the GPIO registers, since the last hostBusReset().
+ *
+ * Counting makes every access a read-modify-write of the counter, which hides the cost of the code around
+ * it. So benchmarks time their runs with counting disabled and count in a separate run.
+ */
+struct HostBusCounters {
+    uint32_t reads;
+    uint32_t writes;
+    bool counting;
+};
+
+inline HostBusCounters hostBus = {};
+
+inline void hostBusReset(const bool counting = true) { hostBus = {0, 0, counting}; }
+
+/**
+ * A 32 bit peripheral register, that counts the accesses to it.
+ */
+class HostRegister {
+public:
+    operator uint32_t() const {
+        if (hostBus.counting) hostBus.reads++;
+        return value;
+    }
+
+    HostRegister &operator=(const uint32_t newValue) {
+        if (hostBus.counting) hostBus.writes++;
+        value = newValue;
+        return *this;
+    }
+
+    /**
+     * @brief Access the value without counting, e.g. to stimulate an input or to check an output.
+     */
+    volatile uint32_t value;
+};
+
+typedef struct {
+    HostRegister CRL;
+    HostRegister CRH;
+    HostRegister IDR;
+    HostRegister ODR;
+    HostRegister BSRR;
+    HostRegister BRR;
+    HostRegister LCKR;
+} GPIO_TypeDef;
+
+#define GPIOA_BASE 0x40010800UL
+#define GPIOB_BASE 0x40010C00UL
+#define GPIOC_BASE 0x40011000UL
+#define GPIOD_BASE 0x40011400UL
+#define GPIOE_BASE 0x40011800UL
+
+#define GPIOA (reinterpret_cast<GPIO_TypeDef *>(GPIOA_BASE))
+#define GPIOB (reinterpret_cast<GPIO_TypeDef *>(GPIOB_BASE))
+#define GPIOC (reinterpret_cast<GPIO_TypeDef *>(GPIOC_BASE))
+#define GPIOD (reinterpret_cast<GPIO_TypeDef *>(GPIOD_BASE))
+#define GPIOE (reinterpret_cast<GPIO_TypeDef *>(GPIOE_BASE))
+
+/**
+ * @brief Map the register file of the GPIO ports.
+ */
+inline void hostGpioInit() {
+    static bool mapped = false;
+    if (mapped) return;
+    constexpr uintptr_t pageBase = GPIOA_BASE & ~static_cast<uintptr_t>(0xFFF);
+    constexpr size_t length = 0x2000;
+    void *memory = mmap(reinterpret_cast<void *>(pageBase), length, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    if (memory != reinterpret_cast<void *>(pageBase)) {
+        std::fprintf(stderr, "can not map the GPIO register file at 0x%lx\n", static_cast<unsigned long>(pageBase));
+        std::exit(1);
+    }
+    std::memset(memory, 0, length);
+    mapped = true;
+}
+
+#define GPIO_PIN_0 ((uint16_t)0x0001)
+#define GPIO_PIN_1 ((uint16_t)0x0002)
+#define GPIO_PIN_2 ((uint16_t)0x0004)
+#define GPIO_PIN_3 ((uint16_t)0x0008)
+#define GPIO_PIN_4 ((uint16_t)0x0010)
+#define GPIO_PIN_5 ((uint16_t)0x0020)
+#define GPIO_PIN_6 ((uint16_t)0x0040)
+#define GPIO_PIN_7 ((uint16_t)0x0080)
+#define GPIO_PIN_8 ((uint16_t)0x0100)
+#define GPIO_PIN_9 ((uint16_t)0x0200)
+#define GPIO_PIN_10 ((uint16_t)0x0400)
+#define GPIO_PIN_11 ((uint16_t)0x0800)
+#define GPIO_PIN_12 ((uint16_t)0x1000)
+#define GPIO_PIN_13 ((uint16_t)0x2000)
+#define GPIO_PIN_14 ((uint16_t)0x4000)
+#define GPIO_PIN_15 ((uint16_t)0x8000)
+
+typedef enum {
+    GPIO_PIN_RESET = 0u,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+__attribute__((noinline)) inline GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) {
+    return (GPIOx->IDR & GPIO_Pin) != static_cast<uint32_t>(GPIO_PIN_RESET) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+__attribute__((noinline)) inline void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin,
+                                                        GPIO_PinState PinState) {
+    if (PinState != GPIO_PIN_RESET) {
+        GPIOx->BSRR = GPIO_Pin;
+    } else {
+        GPIOx->BSRR = static_cast<uint32_t>(GPIO_Pin) << 16u;
+    }
+    // The port drives the pin, and an output reads back its level
+    const uint32_t odr = PinState != GPIO_PIN_RESET ? GPIOx->ODR.value | GPIO_Pin : GPIOx->ODR.value & ~GPIO_Pin;
+    GPIOx->ODR.value = odr;
+    GPIOx->IDR.value = (GPIOx->IDR.value & ~static_cast<uint32_t>(GPIO_Pin)) | (odr & GPIO_Pin);
+}
+
+/**
+ * The tick of the HAL, that is advanced by the test instead of the SysTick interrupt.
+ */
+inline uint32_t hostTickMs = 0;
+
+inline uint32_t HAL_GetTick() { return hostTickMs; }
+
+inline uint32_t __get_PRIMASK() { return 0; }
+
+inline void __set_PRIMASK(uint32_t) {
+}
+
+inline void __disable_irq() {
+}
+
+#endif //LIBSMART_STM32GPIO_HOST_MAIN_H